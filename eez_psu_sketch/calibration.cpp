@@ -49,12 +49,14 @@ void Value::reset() {
     min_set = false;
     mid_set = false;
     max_set = false;
+
+    numPoints = 0;
 }
 
 float Value::getRange() {
     return voltOrCurr ?
-        (g_channel->U_CAL_VAL_MAX - g_channel->U_CAL_VAL_MIN) :
-        (g_channel->I_CAL_VAL_MAX - g_channel->I_CAL_VAL_MIN);
+        (g_channel->getParams().U_CAL_VAL_MAX - g_channel->getParams().U_CAL_VAL_MIN) :
+        (g_channel->getParams().I_CAL_VAL_MAX - g_channel->getParams().I_CAL_VAL_MIN);
 }
 
 bool Value::checkRange(float value, float adc) {
@@ -77,26 +79,30 @@ bool Value::checkRange(float value, float adc) {
 }
 
 float Value::getLevelValue() {
+    if (level == LEVEL_POINT) {
+        return pointLevel;
+    }
+
     if (voltOrCurr) {
         if (level == LEVEL_MIN) {
-            return g_channel->U_CAL_VAL_MIN;
+            return g_channel->getParams().U_CAL_VAL_MIN;
         }
         else if (level == LEVEL_MID) {
-            return g_channel->U_CAL_VAL_MID;
+            return g_channel->getParams().U_CAL_VAL_MID;
         }
         else {
-            return g_channel->U_CAL_VAL_MAX;
+            return g_channel->getParams().U_CAL_VAL_MAX;
         }
     }
     else {
         if (level == LEVEL_MIN) {
-            return g_channel->I_CAL_VAL_MIN;
+            return g_channel->getParams().I_CAL_VAL_MIN;
         }
         else if (level == LEVEL_MID) {
-            return g_channel->I_CAL_VAL_MID;
+            return g_channel->getParams().I_CAL_VAL_MID;
         }
         else {
-            return g_channel->I_CAL_VAL_MAX;
+            return g_channel->getParams().I_CAL_VAL_MAX;
         }
     }
 }
@@ -110,15 +116,55 @@ void Value::setLevel(int8_t value) {
 
     if (voltOrCurr) {
         g_channel->setVoltage(getLevelValue());
-        g_channel->setCurrent(g_channel->I_VOLT_CAL);
+        g_channel->setCurrent(g_channel->getParams().I_VOLT_CAL);
     }
     else {
         g_channel->setCurrent(getLevelValue());
-        g_channel->setVoltage(g_channel->U_CURR_CAL);
+        g_channel->setVoltage(g_channel->getParams().U_CURR_CAL);
+    }
+}
+
+void Value::setPointLevel(float value) {
+    pointLevel = value;
+    setLevel(LEVEL_POINT);
+}
+
+int Value::findPoint(float value) {
+    for (int k = 0; k < numPoints; ++k) {
+        if (point_dac[k] == value) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+bool Value::isPointLevelInRange(float value) {
+    if (voltOrCurr) {
+        return value > g_channel->getParams().U_CAL_VAL_MIN && value < g_channel->getParams().U_CAL_VAL_MAX;
+    } else {
+        return value > g_channel->getParams().I_CAL_VAL_MIN && value < g_channel->getParams().I_CAL_VAL_MAX;
     }
 }
 
+bool Value::canSetPoint(float value) {
+    return numPoints < CALIBRATION_MAX_EXTRA_POINTS || findPoint(value) != -1;
+}
+
 void Value::setData(float data, float adc) {
+    if (level == LEVEL_POINT) {
+        int k = findPoint(pointLevel);
+        if (k == -1) {
+            if (numPoints == CALIBRATION_MAX_EXTRA_POINTS) {
+                return;
+            }
+            k = numPoints++;
+        }
+        point_dac[k] = pointLevel;
+        point_val[k] = data;
+        point_adc[k] = adc;
+        return;
+    }
+
     if (level == LEVEL_MIN) {
         min_set = true;
         min_val = data;
@@ -137,11 +183,11 @@ void Value::setData(float data, float adc) {
 
     if (min_set && max_set) {
         if (voltOrCurr) {
-            g_channel->calibrationFindVoltageRange(g_channel->U_CAL_VAL_MIN, min_val, min_adc, g_channel->U_CAL_VAL_MAX, max_val, max_adc, &minPossible, &maxPossible);
+            g_channel->calibrationFindVoltageRange(g_channel->getParams().U_CAL_VAL_MIN, min_val, min_adc, g_channel->getParams().U_CAL_VAL_MAX, max_val, max_adc, &minPossible, &maxPossible);
             DebugTraceF("Voltage range: %lf - %lfV", minPossible, maxPossible);
         }
         else {
-            g_channel->calibrationFindCurrentRange(g_channel->I_CAL_VAL_MIN, min_val, min_adc, g_channel->I_CAL_VAL_MAX, max_val, max_adc, &minPossible, &maxPossible);
+            g_channel->calibrationFindCurrentRange(g_channel->getParams().I_CAL_VAL_MIN, min_val, min_adc, g_channel->getParams().I_CAL_VAL_MAX, max_val, max_adc, &minPossible, &maxPossible);
             DebugTraceF("Current range: %lf - %lfA", minPossible, maxPossible);
         }
     }
@@ -151,15 +197,60 @@ bool Value::checkMid() {
     float mid;
 
     if (voltOrCurr) {
-        mid = util::remap(g_channel->U_CAL_VAL_MID,
-            g_channel->U_CAL_VAL_MIN, min_val, g_channel->U_CAL_VAL_MAX, max_val);
+        mid = util::remap(g_channel->getParams().U_CAL_VAL_MID,
+            g_channel->getParams().U_CAL_VAL_MIN, min_val, g_channel->getParams().U_CAL_VAL_MAX, max_val);
     }
     else {
-        mid = util::remap(g_channel->I_CAL_VAL_MID,
-            g_channel->I_CAL_VAL_MIN, min_val, g_channel->I_CAL_VAL_MAX, max_val);
+        mid = util::remap(g_channel->getParams().I_CAL_VAL_MID,
+            g_channel->getParams().I_CAL_VAL_MIN, min_val, g_channel->getParams().I_CAL_VAL_MAX, max_val);
+    }
+
+    return fabsf(mid - mid_val) <= CALIBRATION_MID_TOLERANCE_PERCENT * (max_val - min_val) / 100.0f;
+}
+
+bool Value::checkPoints() {
+    float mid_dac = voltOrCurr ? g_channel->getParams().U_CAL_VAL_MID : g_channel->getParams().I_CAL_VAL_MID;
+
+    for (int k = 0; k < numPoints; ++k) {
+        if (!isPointLevelInRange(point_dac[k]) || point_dac[k] == mid_dac) {
+            return false;
+        }
+
+        // measured value and ADC must grow with the DAC value, like min, mid and max
+        if (point_val[k] <= min_val || point_val[k] >= max_val ||
+            point_adc[k] <= min_adc || point_adc[k] >= max_adc) {
+            return false;
+        }
+
+        if (point_dac[k] < mid_dac ?
+            (point_val[k] >= mid_val || point_adc[k] >= mid_adc) :
+            (point_val[k] <= mid_val || point_adc[k] <= mid_adc)) {
+            return false;
+        }
+
+        for (int j = 0; j < numPoints; ++j) {
+            if (point_dac[j] < point_dac[k] && (point_val[j] >= point_val[k] || point_adc[j] >= point_adc[k])) {
+                return false;
+            }
+        }
     }
 
-    return fabsf(mid - mid) <= CALIBRATION_MID_TOLERANCE_PERCENT * (max_val - min_val) / 100.0f;
+    return true;
+}
+
+void Value::getPoints(Channel::CalibrationValuePointConfiguration *points, uint8_t &num) {
+    num = 0;
+    for (int k = 0; k < numPoints; ++k) {
+        int j = num;
+        while (j > 0 && points[j - 1].dac > point_dac[k]) {
+            points[j] = points[j - 1];
+            --j;
+        }
+        points[j].dac = point_dac[k];
+        points[j].val = point_val[k];
+        points[j].adc = point_adc[k];
+        ++num;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -228,6 +319,11 @@ static bool checkCalibrationValue(calibration::Value &calibrationValue, int16_t
         return false;
     }
 
+    if (!calibrationValue.checkPoints()) {
+        scpiErr = SCPI_ERROR_INVALID_CAL_DATA;
+        return false;
+    }
+
     return true;
 }
 
@@ -290,43 +386,49 @@ bool save() {
 
     if (isVoltageCalibrated()) {
         g_channel->cal_conf.flags.u_cal_params_exists = 1;
+        g_channel->cal_conf.flags.u_ignore_mid = 0;
 
-        g_channel->cal_conf.u.min.dac = g_channel->U_CAL_VAL_MIN;
+        g_channel->cal_conf.u.min.dac = g_channel->getParams().U_CAL_VAL_MIN;
         g_channel->cal_conf.u.min.val = g_voltage.min_val;
         g_channel->cal_conf.u.min.adc = g_voltage.min_adc;
 
-        g_channel->cal_conf.u.mid.dac = g_channel->U_CAL_VAL_MID;
+        g_channel->cal_conf.u.mid.dac = g_channel->getParams().U_CAL_VAL_MID;
         g_channel->cal_conf.u.mid.val = g_voltage.mid_val;
         g_channel->cal_conf.u.mid.adc = g_voltage.mid_adc;
 
-        g_channel->cal_conf.u.max.dac = g_channel->U_CAL_VAL_MAX;
+        g_channel->cal_conf.u.max.dac = g_channel->getParams().U_CAL_VAL_MAX;
         g_channel->cal_conf.u.max.val = g_voltage.max_val;
         g_channel->cal_conf.u.max.adc = g_voltage.max_adc;
 
         g_channel->cal_conf.u.minPossible = g_voltage.minPossible;
         g_channel->cal_conf.u.maxPossible = g_voltage.maxPossible;
 
+        g_voltage.getPoints(g_channel->cal_conf.u_extra_points, g_channel->cal_conf.u_num_extra_points);
+
         g_voltage.level = LEVEL_NONE;
     }
 
     if (isCurrentCalibrated()) {
         g_channel->cal_conf.flags.i_cal_params_exists = 1;
+        g_channel->cal_conf.flags.i_ignore_mid = 0;
 
-        g_channel->cal_conf.i.min.dac = g_channel->I_CAL_VAL_MIN;
+        g_channel->cal_conf.i.min.dac = g_channel->getParams().I_CAL_VAL_MIN;
         g_channel->cal_conf.i.min.val = g_current.min_val;
         g_channel->cal_conf.i.min.adc = g_current.min_adc;
 
-        g_channel->cal_conf.i.mid.dac = g_channel->I_CAL_VAL_MID;
+        g_channel->cal_conf.i.mid.dac = g_channel->getParams().I_CAL_VAL_MID;
         g_channel->cal_conf.i.mid.val = g_current.mid_val;
         g_channel->cal_conf.i.mid.adc = g_current.mid_adc;
 
-        g_channel->cal_conf.i.max.dac = g_channel->I_CAL_VAL_MAX;
+        g_channel->cal_conf.i.max.dac = g_channel->getParams().I_CAL_VAL_MAX;
         g_channel->cal_conf.i.max.val = g_current.max_val;
         g_channel->cal_conf.i.max.adc = g_current.max_adc;
 
         g_channel->cal_conf.i.minPossible = g_current.minPossible;
         g_channel->cal_conf.i.maxPossible = g_current.maxPossible;
 
+        g_current.getPoints(g_channel->cal_conf.i_extra_points, g_channel->cal_conf.i_num_extra_points);
+
         g_current.level = LEVEL_NONE;
     }
 
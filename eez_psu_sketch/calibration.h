@@ -27,7 +27,8 @@ enum Level {
     LEVEL_NONE = 0,
     LEVEL_MIN = 1,
     LEVEL_MID = 2,
-    LEVEL_MAX = 3
+    LEVEL_MAX = 3,
+    LEVEL_POINT = 4
 };
 
 /// Calibration parameters for the voltage or current during calibration procedure.
@@ -48,6 +49,15 @@ struct Value {
     float max_val;
     float max_adc;
 
+    /// Additional points between min and max.
+    uint8_t numPoints;
+    float point_dac[CALIBRATION_MAX_EXTRA_POINTS];
+    float point_val[CALIBRATION_MAX_EXTRA_POINTS];
+    float point_adc[CALIBRATION_MAX_EXTRA_POINTS];
+
+    /// DAC value for the LEVEL_POINT.
+    float pointLevel;
+
     float minPossible;
     float maxPossible;
 
@@ -59,13 +69,25 @@ struct Value {
     float getAdcValue();
 
     void  setLevel(int8_t level);
+    void setPointLevel(float value);
     void setData(float data, float adc);
 
+    /// Is DAC value for the additional point between min and max level?
+    bool isPointLevelInRange(float value);
+
+    /// Is there a free entry for the additional point at the given DAC value?
+    bool canSetPoint(float value);
+
     bool checkRange(float value, float adc);
     bool checkMid();
+    bool checkPoints();
+
+    /// Copy additional points, sorted by DAC value, into the calibration configuration.
+    void getPoints(Channel::CalibrationValuePointConfiguration *points, uint8_t &num);
 
 private:
     float getRange();
+    int findPoint(float value);
 };
 
 extern Value g_voltage;
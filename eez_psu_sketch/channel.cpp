@@ -57,20 +57,13 @@ const char *CH_BOARD_REVISION_NAMES[] = {
     "Power_r5B10"
 };
 
-uint16_t CH_BOARD_REVISION_FEATURES[] = {
-    // CH_BOARD_REVISION_R4B43A
-    CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_OE, 
-    // CH_BOARD_REVISION_R5B6B
-    CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_POWER | CH_FEATURE_OE | CH_FEATURE_DPROG | CH_FEATURE_LRIPPLE | CH_FEATURE_RPROG,
-    // CH_BOARD_REVISION_R5B9
-    CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_POWER | CH_FEATURE_OE | CH_FEATURE_DPROG | CH_FEATURE_LRIPPLE | CH_FEATURE_RPROG | CH_FEATURE_RPOL,
-    // CH_BOARD_REVISION_R5B10
-    CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_POWER | CH_FEATURE_OE | CH_FEATURE_DPROG | CH_FEATURE_LRIPPLE | CH_FEATURE_RPROG | CH_FEATURE_RPOL,
-};
-
 ////////////////////////////////////////////////////////////////////////////////
 
-#define CHANNEL(INDEX, BOARD_REVISION, PINS, PARAMS) Channel(INDEX, BOARD_REVISION, PINS, PARAMS)
+#define CHANNEL(INDEX, BOARD_REVISION, PINS, PARAMS) { PARAMS }
+const ChannelParams CH_PARAMS[CH_MAX] = { CHANNELS };
+#undef CHANNEL
+
+#define CHANNEL(INDEX, BOARD_REVISION, PINS, PARAMS) Channel(INDEX, BOARD_REVISION, PINS)
 Channel channels[CH_MAX] = { CHANNELS };
 #undef CHANNEL
 
@@ -139,7 +132,7 @@ char *Channel::getChannelsInfo(char *p) {
         if (!ch_used[i]) {
             int count = 1;
             for (int j = i + 1; j < CH_NUM; ++j) {
-                if (Channel::get(i).U_MAX == Channel::get(j).U_MAX && Channel::get(i).I_MAX == Channel::get(j).I_MAX) {
+                if (Channel::get(i).getParams().U_MAX == Channel::get(j).getParams().U_MAX && Channel::get(i).getParams().I_MAX == Channel::get(j).getParams().I_MAX) {
                     ch_used[j] = true;
                     ++count;
                 }
@@ -153,7 +146,7 @@ char *Channel::getChannelsInfo(char *p) {
                 *p++ += '-';
             }
 
-            p += sprintf_P(p, PSTR("%d/%02d/%02d"), count, (int)floor(Channel::get(i).U_MAX), (int)floor(Channel::get(i).I_MAX));
+            p += sprintf_P(p, PSTR("%d/%02d/%02d"), count, (int)floor(Channel::get(i).getParams().U_MAX), (int)floor(Channel::get(i).getParams().I_MAX));
         }
     }
 
@@ -173,7 +166,7 @@ char *Channel::getChannelsInfoShort(char *p) {
         if (!ch_used[i]) {
             int count = 1;
             for (int j = i + 1; j < CH_NUM; ++j) {
-                if (Channel::get(i).U_MAX == Channel::get(j).U_MAX && Channel::get(i).I_MAX == Channel::get(j).I_MAX) {
+                if (Channel::get(i).getParams().U_MAX == Channel::get(j).getParams().U_MAX && Channel::get(i).getParams().I_MAX == Channel::get(j).getParams().I_MAX) {
                     ch_used[j] = true;
                     ++count;
                 }
@@ -188,7 +181,7 @@ char *Channel::getChannelsInfoShort(char *p) {
                 *p++ += ' ';
             }
 
-            p += sprintf_P(p, PSTR("%d V / %d A"), (int)floor(Channel::get(i).U_MAX), (int)floor(Channel::get(i).I_MAX));
+            p += sprintf_P(p, PSTR("%d V / %d A"), (int)floor(Channel::get(i).getParams().U_MAX), (int)floor(Channel::get(i).getParams().I_MAX));
         }
     }
 
@@ -238,13 +231,7 @@ Channel::Channel(
 #elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
     uint8_t bp_led_out_, uint8_t bp_led_sense_, uint8_t bp_relay_sense_, uint8_t bp_led_prog_,
 #endif
-    uint8_t cc_led_pin_, uint8_t cv_led_pin_,
-    float U_MIN_, float U_DEF_, float U_MAX_, float U_MAX_CONF_, float U_MIN_STEP_, float U_DEF_STEP_, float U_MAX_STEP_, float U_CAL_VAL_MIN_, float U_CAL_VAL_MID_, float U_CAL_VAL_MAX_, float U_CURR_CAL_,
-    bool OVP_DEFAULT_STATE_, float OVP_MIN_DELAY_, float OVP_DEFAULT_DELAY_, float OVP_MAX_DELAY_,
-    float I_MIN_, float I_DEF_, float I_MAX_, float I_MIN_STEP_, float I_DEF_STEP_, float I_MAX_STEP_, float I_CAL_VAL_MIN_, float I_CAL_VAL_MID_, float I_CAL_VAL_MAX_, float I_VOLT_CAL_,
-    bool OCP_DEFAULT_STATE_, float OCP_MIN_DELAY_, float OCP_DEFAULT_DELAY_, float OCP_MAX_DELAY_,
-    bool OPP_DEFAULT_STATE_, float OPP_MIN_DELAY_, float OPP_DEFAULT_DELAY_, float OPP_MAX_DELAY_, float OPP_MIN_LEVEL_, float OPP_DEFAULT_LEVEL_, float OPP_MAX_LEVEL_,
-    float SOA_VIN_, float SOA_PREG_CURR_, float SOA_POSTREG_PTOT_, float PTOT_
+    uint8_t cc_led_pin_, uint8_t cv_led_pin_
     )
     :
     index(index_),
@@ -256,12 +243,6 @@ Channel::Channel(
     bp_led_out(bp_led_out_), bp_led_sense(bp_led_sense_), bp_relay_sense(bp_relay_sense_), bp_led_prog(bp_led_prog_),
 #endif
     cc_led_pin(cc_led_pin_), cv_led_pin(cv_led_pin_),
-    U_MIN(U_MIN_), U_DEF(U_DEF_), U_MAX(U_MAX_), U_MAX_CONF(U_MAX_CONF_), U_MIN_STEP(U_MIN_STEP_), U_DEF_STEP(U_DEF_STEP_), U_MAX_STEP(U_MAX_STEP_), U_CAL_VAL_MIN(U_CAL_VAL_MIN_), U_CAL_VAL_MID(U_CAL_VAL_MID_), U_CAL_VAL_MAX(U_CAL_VAL_MAX_), U_CURR_CAL(U_CURR_CAL_),
-    OVP_DEFAULT_STATE(OVP_DEFAULT_STATE_), OVP_MIN_DELAY(OVP_MIN_DELAY_), OVP_DEFAULT_DELAY(OVP_DEFAULT_DELAY_), OVP_MAX_DELAY(OVP_MAX_DELAY_),
-    I_MIN(I_MIN_), I_DEF(I_DEF_), I_MAX(I_MAX_), I_MIN_STEP(I_MIN_STEP_), I_DEF_STEP(I_DEF_STEP_), I_MAX_STEP(I_MAX_STEP_), I_CAL_VAL_MIN(I_CAL_VAL_MIN_), I_CAL_VAL_MID(I_CAL_VAL_MID_), I_CAL_VAL_MAX(I_CAL_VAL_MAX_), I_VOLT_CAL(I_VOLT_CAL_),
-    OCP_DEFAULT_STATE(OCP_DEFAULT_STATE_), OCP_MIN_DELAY(OCP_MIN_DELAY_), OCP_DEFAULT_DELAY(OCP_DEFAULT_DELAY_), OCP_MAX_DELAY(OCP_MAX_DELAY_),
-    OPP_DEFAULT_STATE(OPP_DEFAULT_STATE_), OPP_MIN_DELAY(OPP_MIN_DELAY_), OPP_DEFAULT_DELAY(OPP_DEFAULT_DELAY_), OPP_MAX_DELAY(OPP_MAX_DELAY_), OPP_MIN_LEVEL(OPP_MIN_LEVEL_), OPP_DEFAULT_LEVEL(OPP_DEFAULT_LEVEL_), OPP_MAX_LEVEL(OPP_MAX_LEVEL_),
-    SOA_VIN(SOA_VIN_), SOA_PREG_CURR(SOA_PREG_CURR_), SOA_POSTREG_PTOT(SOA_POSTREG_PTOT_), PTOT(PTOT_),
     ioexp(*this, IO_BIT_OUT_SET_100_PERCENT_, IO_BIT_OUT_EXT_PROG_),
     adc(*this),
     dac(*this),
@@ -269,16 +250,20 @@ Channel::Channel(
     VOLTAGE_GND_OFFSET(VOLTAGE_GND_OFFSET_),
     CURRENT_GND_OFFSET(CURRENT_GND_OFFSET_)
 {
-    u.min = U_MIN;
-    u.max = U_MAX;
-    u.def = U_DEF;
+    u.min = getParams().U_MIN;
+    u.max = getParams().U_MAX;
+    u.def = getParams().U_DEF;
+
+    i.min = getParams().I_MIN;
+    i.max = getParams().I_MAX;
+    i.def = getParams().I_DEF;
 
-    i.min = I_MIN;
-    i.max = I_MAX;
-    i.def = I_DEF;
+    negligibleAdcDiffForVoltage = (int)((AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN) / (2 * 100 * (getParams().U_MAX - getParams().U_MIN)));
+    negligibleAdcDiffForCurrent = (int)((AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN) / (2 * 100 * (getParams().I_MAX - getParams().I_MIN)));
 
-    negligibleAdcDiffForVoltage = (int)((AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN) / (2 * 100 * (U_MAX - U_MIN)));
-    negligibleAdcDiffForCurrent = (int)((AnalogDigitalConverter::ADC_MAX - AnalogDigitalConverter::ADC_MIN) / (2 * 100 * (I_MAX - I_MIN)));
+    soaVin_mV = (int32_t)(getParams().SOA_VIN * 1000);
+    soaPregCurr_mA = (int32_t)(getParams().SOA_PREG_CURR * 1000);
+    soaPostregPtot_uW = (int32_t)(getParams().SOA_POSTREG_PTOT * 1000000L);
 
 #ifdef EEZ_PSU_SIMULATOR
     simulator.load_enabled = true;
@@ -289,6 +274,8 @@ Channel::Channel(
     }
 #endif
 
+    settingsGeneration = 0;
+
     uBeforeBalancing = NAN;
     iBeforeBalancing = NAN;
 
@@ -298,6 +285,8 @@ Channel::Channel(
 }
 
 void Channel::protectionEnter(ProtectionValue &cpv) {
+    onSettingsChanged();
+
     channel_dispatcher::outputEnable(*this, false);
 
     cpv.flags.tripped = 1;
@@ -332,30 +321,48 @@ void Channel::protectionEnter(ProtectionValue &cpv) {
 
 void Channel::protectionCheck(ProtectionValue &cpv) {
     bool state;
-    bool condition;
-    float delay;
     
     if (IS_OVP_VALUE(this, cpv)) {
         state = flags.rprogEnabled || prot_conf.flags.u_state;
+    }
+    else if (IS_OCP_VALUE(this, cpv)) {
+        state = prot_conf.flags.i_state;
+    }
+    else {
+        state = prot_conf.flags.p_state;
+    }
+
+    // condition goes through channel dispatcher, evaluate it only if protection is armed
+    if (!state || !isOutputEnabled()) {
+        cpv.flags.alarmed = 0;
+        return;
+    }
+
+    bool condition;
+    float delay;
+
+    if (IS_OVP_VALUE(this, cpv)) {
         //condition = flags.cv_mode && (!flags.cc_mode || fabs(i.mon - i.set) >= CHANNEL_VALUE_PRECISION) && (prot_conf.u_level <= u.set);
         condition = util::greaterOrEqual(channel_dispatcher::getUMon(*this), channel_dispatcher::getUProtectionLevel(*this), CHANNEL_VALUE_PRECISION);
         delay = prot_conf.u_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
     else if (IS_OCP_VALUE(this, cpv)) {
-        state = prot_conf.flags.i_state;
         //condition = flags.cc_mode && (!flags.cv_mode || fabs(u.mon - u.set) >= CHANNEL_VALUE_PRECISION);
         condition = util::greaterOrEqual(channel_dispatcher::getIMon(*this), channel_dispatcher::getISet(*this), CHANNEL_VALUE_PRECISION);
         delay = prot_conf.i_delay;
         delay -= PROT_DELAY_CORRECTION;
     }
     else {
-        state = prot_conf.flags.p_state;
-        condition = channel_dispatcher::getUMon(*this) * channel_dispatcher::getIMon(*this) > channel_dispatcher::getPowerProtectionLevel(*this);
+        if (channel_dispatcher::isCoupled()) {
+            condition = channel_dispatcher::getLogicalChannel().power_mW > (int32_t)(channel_dispatcher::getPowerProtectionLevel(*this) * 1000);
+        } else {
+            condition = op.power_mW > (int32_t)(prot_conf.p_level * 1000);
+        }
         delay = prot_conf.p_delay;
     }
 
-    if (state && isOutputEnabled() && condition) {
+    if (condition) {
         if (delay > 0) {
             if (cpv.flags.alarmed) {
                 if (micros() - cpv.alarm_started >= delay * 1000000UL) {
@@ -401,6 +408,8 @@ void Channel::init() {
     adc.init();
     dac.init();
 
+    trend.init(getParams().U_MAX, getParams().I_MAX);
+
     profile::enableSave(last_save_enabled);
 }
 
@@ -420,6 +429,8 @@ void Channel::onPowerDown() {
 }
 
 void Channel::reset() {
+    onSettingsChanged();
+
     flags.outputEnabled = 0;
     flags.dpOn = 0;
     flags.senseEnabled = 0;
@@ -471,11 +482,11 @@ void Channel::reset() {
     // [SOUR[n]]:CURR:STEP
     // [SOUR[n]]:VOLT
     // [SOUR[n]]:VOLT:STEP -> set all to default
-    u.init(U_DEF_STEP, u.max);
-    i.init(I_DEF_STEP, i.max);
+    u.init(getParams().U_DEF_STEP, u.max);
+    i.init(getParams().I_DEF_STEP, i.max);
 
     maxCurrentLimitCause = MAX_CURRENT_LIMIT_CAUSE_NONE;
-    p_limit = PTOT;
+    p_limit = getParams().PTOT;
 
     resetHistory();
 
@@ -484,39 +495,48 @@ void Channel::reset() {
 }
 
 void Channel::resetHistory() {
-    historyPosition = -1;
+    trend.resetSamples();
 }
 
 void Channel::clearCalibrationConf() {
     cal_conf.flags.u_cal_params_exists = 0;
     cal_conf.flags.i_cal_params_exists = 0;
-
-    cal_conf.u.min.dac = cal_conf.u.min.val = cal_conf.u.min.adc = U_CAL_VAL_MIN;
-    cal_conf.u.mid.dac = cal_conf.u.mid.val = cal_conf.u.mid.adc = (U_CAL_VAL_MIN + U_CAL_VAL_MAX) / 2;
-    cal_conf.u.max.dac = cal_conf.u.max.val = cal_conf.u.max.adc = U_CAL_VAL_MAX;
-    cal_conf.u.minPossible = U_MIN;
-    cal_conf.u.maxPossible = U_MAX;
+    cal_conf.flags.u_ignore_mid = 0;
+    cal_conf.flags.i_ignore_mid = 0;
+
+    cal_conf.u.min.dac = cal_conf.u.min.val = cal_conf.u.min.adc = getParams().U_CAL_VAL_MIN;
+    cal_conf.u.mid.dac = cal_conf.u.mid.val = cal_conf.u.mid.adc = (getParams().U_CAL_VAL_MIN + getParams().U_CAL_VAL_MAX) / 2;
+    cal_conf.u.max.dac = cal_conf.u.max.val = cal_conf.u.max.adc = getParams().U_CAL_VAL_MAX;
+    cal_conf.u.minPossible = getParams().U_MIN;
+    cal_conf.u.maxPossible = getParams().U_MAX;
     
-    cal_conf.i.min.dac = cal_conf.i.min.val = cal_conf.i.min.adc = I_CAL_VAL_MIN;
-    cal_conf.i.mid.dac = cal_conf.i.mid.val = cal_conf.i.mid.adc = (I_CAL_VAL_MIN + I_CAL_VAL_MAX) / 2;
-    cal_conf.i.max.dac = cal_conf.i.max.val = cal_conf.i.max.adc = I_CAL_VAL_MAX;
-    cal_conf.i.minPossible = I_MIN;
-    cal_conf.i.maxPossible = I_MAX;
+    cal_conf.i.min.dac = cal_conf.i.min.val = cal_conf.i.min.adc = getParams().I_CAL_VAL_MIN;
+    cal_conf.i.mid.dac = cal_conf.i.mid.val = cal_conf.i.mid.adc = (getParams().I_CAL_VAL_MIN + getParams().I_CAL_VAL_MAX) / 2;
+    cal_conf.i.max.dac = cal_conf.i.max.val = cal_conf.i.max.adc = getParams().I_CAL_VAL_MAX;
+    cal_conf.i.minPossible = getParams().I_MIN;
+    cal_conf.i.maxPossible = getParams().I_MAX;
+
+    memset(cal_conf.u_extra_points, 0, sizeof(cal_conf.u_extra_points));
+    memset(cal_conf.i_extra_points, 0, sizeof(cal_conf.i_extra_points));
+    cal_conf.u_num_extra_points = 0;
+    cal_conf.i_num_extra_points = 0;
 
     strcpy(cal_conf.calibration_date, "");
     strcpy(cal_conf.calibration_remark, CALIBRATION_REMARK_INIT);
 }
 
 void Channel::clearProtectionConf() {
-    prot_conf.flags.u_state = OVP_DEFAULT_STATE;
-    prot_conf.flags.i_state = OCP_DEFAULT_STATE;
-    prot_conf.flags.p_state = OPP_DEFAULT_STATE;
+    onSettingsChanged();
 
-    prot_conf.u_delay = OVP_DEFAULT_DELAY;
+    prot_conf.flags.u_state = getParams().OVP_DEFAULT_STATE;
+    prot_conf.flags.i_state = getParams().OCP_DEFAULT_STATE;
+    prot_conf.flags.p_state = getParams().OPP_DEFAULT_STATE;
+
+    prot_conf.u_delay = getParams().OVP_DEFAULT_DELAY;
     prot_conf.u_level = u.max;
-    prot_conf.i_delay = OCP_DEFAULT_DELAY;
-    prot_conf.p_delay = OPP_DEFAULT_DELAY;
-    prot_conf.p_level = OPP_DEFAULT_LEVEL;
+    prot_conf.i_delay = getParams().OCP_DEFAULT_DELAY;
+    prot_conf.p_delay = getParams().OPP_DEFAULT_DELAY;
+    prot_conf.p_level = getParams().OPP_DEFAULT_LEVEL;
 }
 
 bool Channel::test() {
@@ -538,8 +558,8 @@ bool Channel::test() {
     dac.test();
 
     if (isOk()) {
-        setVoltage(U_DEF);
-        setCurrent(I_DEF);
+        setVoltage(getParams().U_DEF);
+        setCurrent(getParams().I_DEF);
     }
 
     profile::enableSave(last_save_enabled);
@@ -605,10 +625,6 @@ void Channel::tick(uint32_t tick_usec) {
     adc.tick(tick_usec);
     onTimeCounter.tick(tick_usec);
 
-    if (getFeatures() & CH_FEATURE_LRIPPLE) {
-        lowRippleCheck(tick_usec);
-    }
-
     // turn off DP after delay
     if (delayed_dp_off && tick_usec - delayed_dp_off_start >= DP_OFF_DELAY_PERIOD * 1000000L) {
         delayed_dp_off = false;
@@ -620,17 +636,17 @@ void Channel::tick(uint32_t tick_usec) {
     /// and that condition lasts more then DP_NEG_DELAY seconds (default 5 s),
     /// down-programmer circuit has to be switched off.
     if (isOutputEnabled()) {
-        if (u.mon * i.mon >= DP_NEG_LEV || tick_usec < dpNegMonitoringTime) {
+        if (!op.negativePower || tick_usec < dpNegMonitoringTime) {
             dpNegMonitoringTime = tick_usec;
         } else {
             if (tick_usec - dpNegMonitoringTime > DP_NEG_DELAY * 1000000UL) {
                 if (flags.dpOn) {
-                    DebugTraceF("CH%d, neg. P, DP off: %f", index, u.mon * i.mon);
+                    DebugTraceF("CH%d, neg. P, DP off: %f", index, op.power_mW / 1000.0f);
                     dpNegMonitoringTime = tick_usec;
                     psu::generateError(SCPI_ERROR_CH1_DOWN_PROGRAMMER_SWITCHED_OFF + (index - 1));
                     doDpEnable(false);
                 } else {
-                    DebugTraceF("CH%d, neg. P, output off: %f", index, u.mon * i.mon);
+                    DebugTraceF("CH%d, neg. P, output off: %f", index, op.power_mW / 1000.0f);
                     psu::generateError(SCPI_ERROR_CH1_OUTPUT_FAULT_DETECTED - (index - 1));
                     channel_dispatcher::outputEnable(*this, false);
                 }
@@ -657,30 +673,7 @@ void Channel::tick(uint32_t tick_usec) {
     }
 #endif
 
-    if (historyPosition == -1) {
-        uHistory[0] = u.mon;
-        iHistory[0] = i.mon;
-        for (int i = 1; i < CHANNEL_HISTORY_SIZE; ++i) {
-            uHistory[i] = 0;
-            iHistory[i] = 0;
-        }
-            
-        historyPosition = 1;
-        historyLastTick = tick_usec;
-    } else {
-        uint32_t ytViewRateMicroseconds = (int)round(ytViewRate * 1000000L); 
-
-        while (tick_usec - historyLastTick >= ytViewRateMicroseconds) {
-            uHistory[historyPosition] = u.mon;
-            iHistory[historyPosition] = i.mon;
-                
-            if (++historyPosition == CHANNEL_HISTORY_SIZE) {
-                historyPosition = 0;
-            }
-
-            historyLastTick += ytViewRateMicroseconds;
-        }
-    }
+    trend.tick(tick_usec, u.mon, i.mon, ytViewRate);
 
     //if (!util::equal(u.set, u.mon_dac, CHANNEL_VALUE_PRECISION)) {
     //    DebugTraceF("U_SET(%f) <> U_MON_DAC(%f)", u.set, u.mon_dac);
@@ -692,23 +685,104 @@ void Channel::tick(uint32_t tick_usec) {
 }
 
 float Channel::remapAdcDataToVoltage(int16_t adc_data) {
-    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, U_MIN, (float)AnalogDigitalConverter::ADC_MAX, U_MAX);
+    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, getParams().U_MIN, (float)AnalogDigitalConverter::ADC_MAX, getParams().U_MAX);
 }
 
 float Channel::remapAdcDataToCurrent(int16_t adc_data) {
-    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, I_MIN, (float)AnalogDigitalConverter::ADC_MAX, I_MAX);
+    return util::remap((float)adc_data, (float)AnalogDigitalConverter::ADC_MIN, getParams().I_MIN, (float)AnalogDigitalConverter::ADC_MAX, getParams().I_MAX);
 }
 
 int16_t Channel::remapVoltageToAdcData(float value) {
-    float adc_value = util::remap(value, U_MIN, (float)AnalogDigitalConverter::ADC_MIN, U_MAX, (float)AnalogDigitalConverter::ADC_MAX);
+    float adc_value = util::remap(value, getParams().U_MIN, (float)AnalogDigitalConverter::ADC_MIN, getParams().U_MAX, (float)AnalogDigitalConverter::ADC_MAX);
     return (int16_t)util::clamp(adc_value, (float)(-AnalogDigitalConverter::ADC_MAX - 1), (float)AnalogDigitalConverter::ADC_MAX);
 }
 
 int16_t Channel::remapCurrentToAdcData(float value) {
-    float adc_value = util::remap(value, I_MIN, (float)AnalogDigitalConverter::ADC_MIN, I_MAX, (float)AnalogDigitalConverter::ADC_MAX);
+    float adc_value = util::remap(value, getParams().I_MIN, (float)AnalogDigitalConverter::ADC_MIN, getParams().I_MAX, (float)AnalogDigitalConverter::ADC_MAX);
     return (int16_t)util::clamp(adc_value, (float)(-AnalogDigitalConverter::ADC_MAX - 1), (float)AnalogDigitalConverter::ADC_MAX);
 }
 
+void Channel::CalibrationMapping::init(const float *x, const float *y, int numPoints) {
+    float px[CALIBRATION_MAX_POINTS];
+    float py[CALIBRATION_MAX_POINTS];
+    int n = 0;
+
+    // insertion sort by x, points with the same x are skipped
+    for (int k = 0; k < numPoints && n < CALIBRATION_MAX_POINTS; ++k) {
+        int j = n;
+        while (j > 0 && px[j - 1] > x[k]) {
+            --j;
+        }
+        if ((j > 0 && px[j - 1] == x[k]) || (j < n && px[j] == x[k])) {
+            continue;
+        }
+        for (int m = n; m > j; --m) {
+            px[m] = px[m - 1];
+            py[m] = py[m - 1];
+        }
+        px[j] = x[k];
+        py[j] = y[k];
+        ++n;
+    }
+
+    if (n < 2) {
+        numSegments = 1;
+        slope[0] = 1.0f;
+        offset[0] = 0;
+        return;
+    }
+
+    numSegments = n - 1;
+    for (int k = 0; k < numSegments; ++k) {
+        slope[k] = (py[k + 1] - py[k]) / (px[k + 1] - px[k]);
+        offset[k] = py[k] - slope[k] * px[k];
+        if (k > 0) {
+            bound[k - 1] = px[k];
+        }
+    }
+}
+
+float Channel::CalibrationMapping::map(float value) const {
+    uint8_t lo = 0;
+    uint8_t hi = numSegments - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (value < bound[mid]) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return slope[lo] * value + offset[lo];
+}
+
+void Channel::prepareCalibrationMapping(const CalibrationValueConfiguration &valueConf, bool ignoreMid, const CalibrationValuePointConfiguration *extraPoints, uint8_t numExtraPoints, CalibrationMapping &monMapping, CalibrationMapping &setMapping) {
+    float dacPoints[CALIBRATION_MAX_POINTS];
+    float valPoints[CALIBRATION_MAX_POINTS];
+    float adcPoints[CALIBRATION_MAX_POINTS];
+
+    const CalibrationValuePointConfiguration *points[3] = { &valueConf.min, &valueConf.mid, &valueConf.max };
+
+    int n = 0;
+    for (int k = 0; k < 3; ++k) {
+        if (ignoreMid && points[k] == &valueConf.mid) {
+            continue;
+        }
+        dacPoints[n] = points[k]->dac;
+        valPoints[n] = points[k]->val;
+        adcPoints[n] = points[k]->adc;
+        ++n;
+    }
+    for (int k = 0; k < numExtraPoints && k < CALIBRATION_MAX_EXTRA_POINTS; ++k, ++n) {
+        dacPoints[n] = extraPoints[k].dac;
+        valPoints[n] = extraPoints[k].val;
+        adcPoints[n] = extraPoints[k].adc;
+    }
+
+    monMapping.init(adcPoints, valPoints, n);
+    setMapping.init(valPoints, dacPoints, n);
+}
+
 void Channel::adcDataIsReady(int16_t data) {
     uint8_t nextStartReg0 = 0;
 
@@ -727,7 +801,7 @@ void Channel::adcDataIsReady(int16_t data) {
         float value = remapAdcDataToVoltage(u.mon_adc) - VOLTAGE_GND_OFFSET;
 
         if (isVoltageCalibrationEnabled()) {
-            u.mon = util::remap(value, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
+            u.mon = uMonCalMapping.map(value);
         } else {
             u.mon = value;
         }
@@ -749,7 +823,7 @@ void Channel::adcDataIsReady(int16_t data) {
         float value = remapAdcDataToCurrent(i.mon_adc) - CURRENT_GND_OFFSET;
 
         if (isCurrentCalibrationEnabled()) {
-            i.mon = util::remap(value, cal_conf.i.min.adc, cal_conf.i.min.val, cal_conf.i.max.adc, cal_conf.i.max.val);
+            i.mon = iMonCalMapping.map(value);
         } else {
             i.mon = value;
         }
@@ -769,6 +843,13 @@ void Channel::adcDataIsReady(int16_t data) {
             i.mon = 0;
             nextStartReg0 = AnalogDigitalConverter::ADC_REG0_READ_U_SET;
         }
+
+        // U is sampled just before I, so this completes the pair
+        updateOperatingPoint();
+
+        if (getFeatures() & CH_FEATURE_LRIPPLE) {
+            lowRippleCheck(micros());
+        }
     }
     break;
 
@@ -781,7 +862,7 @@ void Channel::adcDataIsReady(int16_t data) {
         float value = remapAdcDataToVoltage(data) - VOLTAGE_GND_OFFSET;
 
         if (isVoltageCalibrationEnabled()) {
-            u.mon_dac = util::remap(value, cal_conf.u.min.adc, cal_conf.u.min.val, cal_conf.u.max.adc, cal_conf.u.max.val);
+            u.mon_dac = uMonCalMapping.map(value);
         } else {
             u.mon_dac = value;
         }
@@ -804,7 +885,7 @@ void Channel::adcDataIsReady(int16_t data) {
         float value = remapAdcDataToCurrent(data) - CURRENT_GND_OFFSET;
 
         if (isCurrentCalibrationEnabled()) {
-            i.mon_dac = util::remap(value, cal_conf.i.min.adc, cal_conf.i.min.val, cal_conf.i.max.adc, cal_conf.i.max.val);
+            i.mon_dac = iMonCalMapping.map(value);
         } else {
             i.mon_dac = value;
         }
@@ -816,6 +897,8 @@ void Channel::adcDataIsReady(int16_t data) {
     break;
     }
 
+    channel_dispatcher::onChannelSample(*this);
+
     adc.start(nextStartReg0);
 }
 
@@ -960,6 +1043,8 @@ void Channel::doDpEnable(bool enable) {
 }
 
 void Channel::doOutputEnable(bool enable) {
+    onSettingsChanged();
+
     if (!psu::g_isBooted) {
         flags.afterBootOutputEnabled = enable;
         return;
@@ -1023,6 +1108,8 @@ void Channel::doOutputEnable(bool enable) {
 }
 
 void Channel::doRemoteSensingEnable(bool enable) {
+    onSettingsChanged();
+
     if (enable && !isOk()) {
         return;
     }
@@ -1032,6 +1119,8 @@ void Channel::doRemoteSensingEnable(bool enable) {
 }
 
 void Channel::doRemoteProgrammingEnable(bool enable) {
+    onSettingsChanged();
+
     if (enable && !isOk()) {
         return;
     }
@@ -1064,15 +1153,27 @@ bool Channel::isLowRippleAllowed(uint32_t tick_usec) {
         delayLowRippleCheck = false;
     }
 
-    if (i.mon > SOA_PREG_CURR || i.mon > SOA_POSTREG_PTOT / (SOA_VIN - u.mon)) {
-        return false;
-    }
+    return op.lowRippleAllowed;
+}
 
-    if (i.mon * (SOA_VIN - u.mon) > SOA_POSTREG_PTOT) {
-        return false;
-    }
+void Channel::updateOperatingPoint() {
+    int32_t u_mV = (int32_t)(u.mon * 1000);
+    int32_t i_mA = (int32_t)(i.mon * 1000);
 
-    return true;
+    op.power_mW = u_mV * i_mA / 1000;
+    op.negativePower = op.power_mW < DP_NEG_LEV * 1000L;
+
+    int32_t dissipation_uW = i_mA * (soaVin_mV - u_mV);
+
+    if (op.lowRippleAllowed) {
+        // leave as soon as SOA is exceeded
+        op.lowRippleAllowed = i_mA <= soaPregCurr_mA && dissipation_uW <= soaPostregPtot_uW;
+    } else {
+        // enter only with some margin, so the mode doesn't toggle on every sample at the SOA boundary
+        op.lowRippleAllowed =
+            i_mA <= soaPregCurr_mA - soaPregCurr_mA / 100 * LOW_RIPPLE_SOA_HYSTERESIS &&
+            dissipation_uW <= soaPostregPtot_uW - soaPostregPtot_uW / 100 * LOW_RIPPLE_SOA_HYSTERESIS;
+    }
 }
 
 void Channel::lowRippleCheck(uint32_t tick_usec) {
@@ -1090,11 +1191,15 @@ void Channel::lowRippleCheck(uint32_t tick_usec) {
 }
 
 void Channel::doLowRippleEnable(bool enable) {
+    onSettingsChanged();
+
     flags.lrippleEnabled = enable;
     ioexp.changeBit(ioexp.IO_BIT_OUT_SET_100_PERCENT, !enable);
 }
 
 void Channel::doLowRippleAutoEnable(bool enable) {
+    onSettingsChanged();
+
     if (enable && !isOk()) {
         return;
     }
@@ -1102,6 +1207,8 @@ void Channel::doLowRippleAutoEnable(bool enable) {
 }
 
 void Channel::update() {
+    onSettingsChanged();
+
     if (!isOk()) {
         return;
     }
@@ -1139,38 +1246,45 @@ bool Channel::isOutputEnabled() {
 }
 
 void Channel::doCalibrationEnable(bool enable) {
+    onSettingsChanged();
+
     flags._calEnabled = enable;
 
     if (enable) {
+        prepareCalibrationMapping(cal_conf.u, cal_conf.flags.u_ignore_mid ? true : false, cal_conf.u_extra_points, cal_conf.u_num_extra_points, uMonCalMapping, uSetCalMapping);
+        prepareCalibrationMapping(cal_conf.i, cal_conf.flags.i_ignore_mid ? true : false, cal_conf.i_extra_points, cal_conf.i_num_extra_points, iMonCalMapping, iSetCalMapping);
+
         u.min = util::floorPrec(cal_conf.u.minPossible, CHANNEL_VALUE_PRECISION);
-        if (u.min < U_MIN) u.min = U_MIN;
+        if (u.min < getParams().U_MIN) u.min = getParams().U_MIN;
         if (u.limit < u.min) u.limit = u.min;
         if (u.set < u.min) setVoltage(u.min);
         
         u.max = util::ceilPrec(cal_conf.u.maxPossible, CHANNEL_VALUE_PRECISION);
-        if (u.max > U_MAX) u.max = U_MAX;
+        if (u.max > getParams().U_MAX) u.max = getParams().U_MAX;
         if (u.set > u.max) setVoltage(u.max);
         if (u.limit > u.max) u.limit = u.max;
 
         i.min = util::floorPrec(cal_conf.i.minPossible, CHANNEL_VALUE_PRECISION);
-        if (i.min < I_MIN) i.min = I_MIN;
+        if (i.min < getParams().I_MIN) i.min = getParams().I_MIN;
         if (i.limit < i.min) i.limit = i.min;
         if (i.set < i.min) setCurrent(i.min);
 
         i.max = util::ceilPrec(cal_conf.i.maxPossible, CHANNEL_VALUE_PRECISION);
-        if (i.max > I_MAX) i.max = I_MAX;
+        if (i.max > getParams().I_MAX) i.max = getParams().I_MAX;
         if (i.limit > i.max) i.limit = i.max;
         if (i.set > i.max) setCurrent(i.max);
     } else {
-        u.min = U_MIN;
-        u.max = U_MAX;
+        u.min = getParams().U_MIN;
+        u.max = getParams().U_MAX;
 
-        i.min = I_MIN;
-        i.max = I_MAX;
+        i.min = getParams().I_MIN;
+        i.max = getParams().I_MAX;
     }
 
     u.def = u.min;
     i.def = i.min;
+
+    channel_dispatcher::onChannelChanged(*this);
 }
 
 void Channel::calibrationEnable(bool enable) {
@@ -1203,8 +1317,8 @@ bool Channel::isCurrentCalibrationEnabled() {
 
 void Channel::calibrationFindVoltageRange(float minDac, float minVal, float minAdc, float maxDac, float maxVal, float maxAdc, float *min, float *max) {
     if (boardRevision == CH_BOARD_REVISION_R5B6B || boardRevision == CH_BOARD_REVISION_R5B10) {
-        *min = U_MIN;
-        *max = U_MAX;
+        *min = getParams().U_MIN;
+        *max = getParams().U_MAX;
         return;
     }
 
@@ -1213,17 +1327,13 @@ void Channel::calibrationFindVoltageRange(float minDac, float minVal, float minA
     bool u_cal_params_exists = cal_conf.flags.u_cal_params_exists;
     cal_conf.flags.u_cal_params_exists = true;
 
-    CalibrationValueConfiguration calValueConf;
-    calValueConf = cal_conf.u;
+    float dacPoints[2] = { minDac, maxDac };
+    float valPoints[2] = { minVal, maxVal };
+    float adcPoints[2] = { minAdc, maxAdc };
+    uMonCalMapping.init(adcPoints, valPoints, 2);
+    uSetCalMapping.init(valPoints, dacPoints, 2);
 
-    cal_conf.u.min.dac = minDac;
-    cal_conf.u.min.val = minVal;
-    cal_conf.u.min.adc = minAdc;
-    cal_conf.u.max.dac = maxDac;
-    cal_conf.u.max.val = maxVal;
-    cal_conf.u.max.adc = maxAdc;
-
-    doSetVoltage(U_MIN);
+    doSetVoltage(getParams().U_MIN);
     delay(100);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
@@ -1234,7 +1344,7 @@ void Channel::calibrationFindVoltageRange(float minDac, float minVal, float minA
     //DebugTraceF("MON_ADC=%d", (int)u.mon_adc);
     *min = u.mon;
 
-    doSetVoltage(U_MAX);
+    doSetVoltage(getParams().U_MAX);
     delay(200); // guard time, because without load it will require more than 15ms to jump to the max
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_U_MON);
@@ -1246,15 +1356,14 @@ void Channel::calibrationFindVoltageRange(float minDac, float minVal, float minA
     *max = u.mon;
 
     cal_conf.flags.u_cal_params_exists = u_cal_params_exists;
-    cal_conf.u = calValueConf;
 
     flags._calEnabled = false;
 }
 
 void Channel::calibrationFindCurrentRange(float minDac, float minVal, float minAdc, float maxDac, float maxVal, float maxAdc, float *min, float *max) {
     if (boardRevision == CH_BOARD_REVISION_R5B6B || boardRevision == CH_BOARD_REVISION_R5B10) {
-        *min = I_MIN;
-        *max = I_MAX;
+        *min = getParams().I_MIN;
+        *max = getParams().I_MAX;
         return;
     }
 
@@ -1263,17 +1372,13 @@ void Channel::calibrationFindCurrentRange(float minDac, float minVal, float minA
     bool i_cal_params_exists = cal_conf.flags.i_cal_params_exists;
     cal_conf.flags.i_cal_params_exists = true;
 
-    CalibrationValueConfiguration calValueConf;
-    calValueConf = cal_conf.i;
-
-    cal_conf.i.min.dac = minDac;
-    cal_conf.i.min.val = minVal;
-    cal_conf.i.min.adc = minAdc;
-    cal_conf.i.max.dac = maxDac;
-    cal_conf.i.max.val = maxVal;
-    cal_conf.i.max.adc = maxAdc;
+    float dacPoints[2] = { minDac, maxDac };
+    float valPoints[2] = { minVal, maxVal };
+    float adcPoints[2] = { minAdc, maxAdc };
+    iMonCalMapping.init(adcPoints, valPoints, 2);
+    iSetCalMapping.init(valPoints, dacPoints, 2);
 
-    doSetCurrent(I_MIN);
+    doSetCurrent(getParams().I_MIN);
     delay(100);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
@@ -1284,7 +1389,7 @@ void Channel::calibrationFindCurrentRange(float minDac, float minVal, float minA
     //DebugTraceF("MON_ADC=%d", (int)i.mon_adc);
     *min = i.mon;
 
-    doSetCurrent(I_MAX);
+    doSetCurrent(getParams().I_MAX);
     delay(100);
 #if !ADC_USE_INTERRUPTS
     adc.start(AnalogDigitalConverter::ADC_REG0_READ_I_MON);
@@ -1296,7 +1401,6 @@ void Channel::calibrationFindCurrentRange(float minDac, float minVal, float minA
     *max = i.mon;
 
     cal_conf.flags.i_cal_params_exists = i_cal_params_exists;
-    cal_conf.i = calValueConf;
 
     flags._calEnabled = false;
 }
@@ -1352,19 +1456,22 @@ bool Channel::isLowRippleAutoEnabled() {
 }
 
 void Channel::doSetVoltage(float value) {
+    onSettingsChanged();
+
     u.set = value;
     u.mon_dac = 0;
+    channel_dispatcher::onChannelChanged(*this);
 
     if (prot_conf.u_level < u.set) {
         prot_conf.u_level = u.set;
     }
 
-    if (U_MAX != U_MAX_CONF) {
-        value = util::remap(value, 0, 0, U_MAX_CONF, U_MAX);
+    if (getParams().U_MAX != getParams().U_MAX_CONF) {
+        value = util::remap(value, 0, 0, getParams().U_MAX_CONF, getParams().U_MAX);
     }
 
     if (isVoltageCalibrationEnabled()) {
-        value = util::remap(value, cal_conf.u.min.val, cal_conf.u.min.dac, cal_conf.u.max.val, cal_conf.u.max.dac);
+        value = uSetCalMapping.map(value);
     }
 
     value += VOLTAGE_GND_OFFSET;
@@ -1382,11 +1489,14 @@ void Channel::setVoltage(float value) {
 }
 
 void Channel::doSetCurrent(float value) {
+    onSettingsChanged();
+
     i.set = value;
     i.mon_dac = 0;
+    channel_dispatcher::onChannelChanged(*this);
 
     if (isCurrentCalibrationEnabled()) {
-        value = util::remap(value, cal_conf.i.min.val, cal_conf.i.min.dac, cal_conf.i.max.val, cal_conf.i.max.dac);
+        value = iSetCalMapping.map(value);
     }
 
     value += CURRENT_GND_OFFSET;
@@ -1415,6 +1525,8 @@ bool Channel::isTripped() {
 }
 
 void Channel::clearProtection() {
+    onSettingsChanged();
+
     event_queue::Event lastEvent;
     event_queue::getLastErrorEvent(&lastEvent);
 
@@ -1443,6 +1555,8 @@ void Channel::clearProtection() {
 }
 
 void Channel::disableProtection() {
+    onSettingsChanged();
+
     if (!isTripped()) {
         prot_conf.flags.u_state = 0;
         prot_conf.flags.i_state = 0;
@@ -1479,10 +1593,6 @@ const char *Channel::getBoardRevisionName() {
     return CH_BOARD_REVISION_NAMES[boardRevision];
 }
 
-uint16_t Channel::getFeatures() {
-    return CH_BOARD_REVISION_FEATURES[boardRevision];
-}
-
 float Channel::getVoltageLimit() const {
     return u.limit;
 }
@@ -1492,6 +1602,8 @@ float Channel::getVoltageMaxLimit() const {
 }
 
 void Channel::setVoltageLimit(float limit) {
+    onSettingsChanged();
+
     u.limit = limit;
     if (u.set > u.limit) {
         setVoltage(u.limit);
@@ -1504,6 +1616,8 @@ float Channel::getCurrentLimit() const {
 }
 
 void Channel::setCurrentLimit(float limit) {
+    onSettingsChanged();
+
     if (limit > getMaxCurrentLimit()) {
         limit = getMaxCurrentLimit();
     }
@@ -1530,6 +1644,8 @@ MaxCurrentLimitCause Channel::getMaxCurrentLimitCause() const {
 }
 
 void Channel::limitMaxCurrent(MaxCurrentLimitCause cause) {
+    onSettingsChanged();
+
     if (cause != maxCurrentLimitCause) {
         maxCurrentLimitCause = cause;
 
@@ -1546,6 +1662,8 @@ void Channel::limitMaxCurrent(MaxCurrentLimitCause cause) {
 }
 
 void Channel::unlimitMaxCurrent() {
+    onSettingsChanged();
+
     limitMaxCurrent(MAX_CURRENT_LIMIT_CAUSE_NONE);
 }
 
@@ -1554,10 +1672,12 @@ float Channel::getPowerLimit() const {
 }
 
 float Channel::getPowerMaxLimit() const {
-    return PTOT;
+    return getParams().PTOT;
 }
 
 void Channel::setPowerLimit(float limit) {
+    onSettingsChanged();
+
     p_limit = limit;
     if (u.set * i.set > p_limit) {
         //setVoltage(p_limit / i.set);
@@ -23,6 +23,7 @@
 #include "adc.h"
 #include "dac.h"
 #include "temp_sensor.h"
+#include "trend.h"
 
 #define IS_OVP_VALUE(channel, cpv) (&cpv == &channel->ovp)
 #define IS_OCP_VALUE(channel, cpv) (&cpv == &channel->ocp)
@@ -52,6 +53,93 @@ enum ChannelFeatures {
     CH_FEATURE_RPOL = (1 << 8)
 };
 
+/// Features present in the given board revision. Takes all the
+/// CH_BOARD_REVISION_*_PARAMS so it can be used from the CHANNEL macro,
+/// only the first one (board revision) is used.
+template <typename... BoardRevisionParams>
+constexpr uint16_t getBoardRevisionFeatures(int boardRevision, BoardRevisionParams...) {
+    return
+        boardRevision == CH_BOARD_REVISION_R4B43A ?
+            CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_OE :
+        boardRevision == CH_BOARD_REVISION_R5B6B ?
+            CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_POWER | CH_FEATURE_OE | CH_FEATURE_DPROG | CH_FEATURE_LRIPPLE | CH_FEATURE_RPROG :
+        boardRevision == CH_BOARD_REVISION_R5B9 || boardRevision == CH_BOARD_REVISION_R5B10 ?
+            CH_FEATURE_VOLT | CH_FEATURE_CURRENT | CH_FEATURE_POWER | CH_FEATURE_OE | CH_FEATURE_DPROG | CH_FEATURE_LRIPPLE | CH_FEATURE_RPROG | CH_FEATURE_RPOL :
+        0;
+}
+
+/// Features of each channel from CHANNELS configuration.
+#define CHANNEL(INDEX, BOARD_REVISION, PINS, PARAMS) getBoardRevisionFeatures(BOARD_REVISION)
+constexpr uint16_t CH_FEATURES[CH_MAX] = { CHANNELS };
+#undef CHANNEL
+
+constexpr uint16_t getFeaturesOfAllChannels(int i = 0) {
+    return i == CH_NUM ? 0xFFFF : CH_FEATURES[i] & getFeaturesOfAllChannels(i + 1);
+}
+
+constexpr uint16_t getFeaturesOfAnyChannel(int i = 0) {
+    return i == CH_NUM ? 0 : CH_FEATURES[i] | getFeaturesOfAnyChannel(i + 1);
+}
+
+/// Features present in every channel, checks for them are always true.
+constexpr uint16_t CH_FEATURES_ALL = getFeaturesOfAllChannels();
+
+/// Features present in at least one channel, checks for the others are always false.
+constexpr uint16_t CH_FEATURES_ANY = getFeaturesOfAnyChannel();
+
+/// Parameters of the channel model, in the order of the CH_PARAMS_* values.
+struct ChannelParams {
+    float U_MIN;
+    float U_DEF;
+    float U_MAX;
+    float U_MAX_CONF;
+    float U_MIN_STEP;
+    float U_DEF_STEP;
+    float U_MAX_STEP;
+    float U_CAL_VAL_MIN;
+    float U_CAL_VAL_MID;
+    float U_CAL_VAL_MAX;
+    float U_CURR_CAL; // voltage level during current calibration
+
+    bool OVP_DEFAULT_STATE;
+    float OVP_MIN_DELAY;
+    float OVP_DEFAULT_DELAY;
+    float OVP_MAX_DELAY;
+
+    float I_MIN;
+    float I_DEF;
+    float I_MAX;
+    float I_MIN_STEP;
+    float I_DEF_STEP;
+    float I_MAX_STEP;
+    float I_CAL_VAL_MIN;
+    float I_CAL_VAL_MID;
+    float I_CAL_VAL_MAX;
+    float I_VOLT_CAL; // current level during voltage calibration
+
+    bool OCP_DEFAULT_STATE;
+    float OCP_MIN_DELAY;
+    float OCP_DEFAULT_DELAY;
+    float OCP_MAX_DELAY;
+
+    bool OPP_DEFAULT_STATE;
+    float OPP_MIN_DELAY;
+    float OPP_DEFAULT_DELAY;
+    float OPP_MAX_DELAY;
+    float OPP_MIN_LEVEL;
+    float OPP_DEFAULT_LEVEL;
+    float OPP_MAX_LEVEL;
+
+    float SOA_VIN;
+    float SOA_PREG_CURR;
+    float SOA_POSTREG_PTOT;
+
+    float PTOT;
+};
+
+/// Parameters of each channel from CHANNELS configuration.
+extern const ChannelParams CH_PARAMS[CH_MAX];
+
 enum TriggerMode {
     TRIGGER_MODE_FIXED,
     TRIGGER_MODE_LIST,
@@ -70,6 +158,10 @@ public:
         unsigned u_cal_params_exists : 1; 
         /// Is current calibrated?
         unsigned i_cal_params_exists : 1;
+        /// Leave voltage mid point out of the mapping? Set for the calibration saved before version 4, where mid point was not validated.
+        unsigned u_ignore_mid : 1;
+        /// Leave current mid point out of the mapping? Set for the calibration saved before version 4, where mid point was not validated.
+        unsigned i_ignore_mid : 1;
     };
 
     /// Calibration parameters for the single point.
@@ -83,13 +175,14 @@ public:
     };
 
     /// Calibration parameters for the voltage and current.
-    /// There are three points defined: `min`, `mid` and `max`.
-    /// Only `min` and `max` are used in actual calculations -
-    /// `mid` is only used for the validity checking.
-    /// Here is how `DAC` value is calculated from the `real_value` set by user:
-    /// `DAC = min.dac + (real_value - min.val) * (max.dac - min.dac) / (max.val - min.val);`
-    /// And here is how `real_value` is calculated from the `ADC` value:
-    /// `real_value = min.val + (ADC - min.adc) * (max.val - min.val) / (max.adc - min.adc);`
+    /// There are three points defined: `min`, `mid` and `max`, and there can be
+    /// up to `CALIBRATION_MAX_EXTRA_POINTS` additional points between `min` and `max`
+    /// (see `CalibrationConfiguration`). Values are mapped with the piecewise linear
+    /// function through all the points, for example between `min` and `mid`
+    /// `DAC` value is calculated from the `real_value` set by user like this:
+    /// `DAC = min.dac + (real_value - min.val) * (mid.dac - min.dac) / (mid.val - min.val);`
+    /// And `real_value` is calculated from the `ADC` value like this:
+    /// `real_value = min.val + (ADC - min.adc) * (mid.val - min.val) / (mid.adc - min.adc);`
     struct CalibrationValueConfiguration {
         /// Min point.
         CalibrationValuePointConfiguration min;
@@ -126,6 +219,37 @@ public:
 
         /// Remark about calibration set by user.
         char calibration_remark[CALIBRATION_REMARK_MAX_LENGTH + 1];
+
+        /// Additional voltage calibration points, sorted by DAC value.
+        /// Added in version 4, that's why they are not in `CalibrationValueConfiguration`.
+        CalibrationValuePointConfiguration u_extra_points[CALIBRATION_MAX_EXTRA_POINTS];
+
+        /// Additional current calibration points, sorted by DAC value.
+        CalibrationValuePointConfiguration i_extra_points[CALIBRATION_MAX_EXTRA_POINTS];
+
+        /// Number of used entries in `u_extra_points`.
+        uint8_t u_num_extra_points;
+
+        /// Number of used entries in `i_extra_points`.
+        uint8_t i_num_extra_points;
+    };
+
+    /// Piecewise linear function through the calibration points.
+    /// Slope and offset of every segment are precomputed when calibration is enabled,
+    /// so mapping a value is a binary search for its segment and one multiply-add.
+    struct CalibrationMapping {
+        /// Number of segments, at least one.
+        uint8_t numSegments;
+        /// Upper bound of every segment except the last one.
+        float bound[CALIBRATION_MAX_POINTS - 2];
+        float slope[CALIBRATION_MAX_POINTS - 1];
+        float offset[CALIBRATION_MAX_POINTS - 1];
+
+        /// Build mapping through the points (x[k], y[k]), they don't need to be sorted.
+        void init(const float *x, const float *y, int numPoints);
+
+        /// Map value, outside of the points first or last segment is extrapolated.
+        float map(float value) const;
     };
 
     /// Binary flags for the channel protection configuration
@@ -187,6 +311,15 @@ public:
         void init(float def_step, float def_limit);
     };
 
+    /// Operating point derived from the latest U/I sample pair.
+    /// Updated when the current sample arrives, so tick, protections and discovery
+    /// read it instead of recomputing it from u.mon and i.mon.
+    struct OperatingPoint {
+        int32_t power_mW;      // u.mon * i.mon
+        unsigned lowRippleAllowed : 1; // within post-regulator SOA, with hysteresis
+        unsigned negativePower : 1;    // power below DP_NEG_LEV
+    };
+
     /// Runtime protection binary flags (alarmed, tripped)
     struct ProtectionFlags {
         unsigned alarmed : 1;
@@ -264,46 +397,6 @@ public:
     uint8_t cc_led_pin;
     uint8_t cv_led_pin;
 
-    float U_MIN_STEP;
-    float U_DEF_STEP;
-    float U_MAX_STEP;
-    float U_CAL_VAL_MIN;
-    float U_CAL_VAL_MID;
-    float U_CAL_VAL_MAX;
-    float U_CURR_CAL; // voltage level during current calibration
-
-    bool OVP_DEFAULT_STATE;
-    float OVP_MIN_DELAY;
-    float OVP_DEFAULT_DELAY;
-    float OVP_MAX_DELAY;
-
-    float I_MIN_STEP;
-    float I_DEF_STEP;
-    float I_MAX_STEP;
-    float I_CAL_VAL_MIN;
-    float I_CAL_VAL_MID;
-    float I_CAL_VAL_MAX;
-    float I_VOLT_CAL; // current level during voltage calibration
-
-    bool OCP_DEFAULT_STATE;
-    float OCP_MIN_DELAY;
-    float OCP_DEFAULT_DELAY;
-    float OCP_MAX_DELAY;
-
-    bool OPP_DEFAULT_STATE;
-    float OPP_MIN_DELAY;
-    float OPP_DEFAULT_DELAY;
-    float OPP_MAX_DELAY;
-    float OPP_MIN_LEVEL;
-    float OPP_DEFAULT_LEVEL;
-    float OPP_MAX_LEVEL;
-
-    float SOA_VIN;
-    float SOA_PREG_CURR;
-    float SOA_POSTREG_PTOT;
-
-    float PTOT;
-
     IOExpander ioexp;
     AnalogDigitalConverter adc;
     DigitalAnalogConverter dac;
@@ -313,6 +406,8 @@ public:
     Value u;
     Value i;
 
+    OperatingPoint op;
+
     float p_limit;
 
     CalibrationConfiguration cal_conf;
@@ -324,6 +419,9 @@ public:
 
     ontime::Counter onTimeCounter;
 
+    /// History of the measured values, for the YT view and the trend query.
+    trend::History trend;
+
     float ytViewRate;
 
 #ifdef EEZ_PSU_SIMULATOR
@@ -339,13 +437,7 @@ public:
 #elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
         uint8_t bp_led_out, uint8_t bp_led_sense, uint8_t bp_relay_sense, uint8_t bp_led_prog,
 #endif
-        uint8_t cc_led_pin, uint8_t cv_led_pin,
-        float U_MIN, float U_DEF, float U_MAX, float U_MAX_CONF, float U_MIN_STEP, float U_DEF_STEP, float U_MAX_STEP, float U_CAL_VAL_MIN, float U_CAL_VAL_MID, float U_CAL_VAL_MAX, float U_CURR_CAL,
-        bool OVP_DEFAULT_STATE, float OVP_MIN_DELAY, float OVP_DEFAULT_DELAY, float OVP_MAX_DELAY,
-        float I_MIN, float I_DEF, float I_MAX, float I_MIN_STEP, float I_DEF_STEP, float I_MAX_STEP, float I_CAL_VAL_MIN, float I_CAL_VAL_MID, float I_CAL_VAL_MAX, float I_VOLT_CAL,
-        bool OCP_DEFAULT_STATE, float OCP_MIN_DELAY, float OCP_DEFAULT_DELAY, float OCP_MAX_DELAY,
-        bool OPP_DEFAULT_STATE, float OPP_MIN_DELAY, float OPP_DEFAULT_DELAY, float OPP_MAX_DELAY, float OPP_MIN_LEVEL, float OPP_DEFAULT_LEVEL, float OPP_MAX_LEVEL,
-        float SOA_VIN, float SOA_PREG_CURR, float SOA_POSTREG_PTOT, float PTOT);
+        uint8_t cc_led_pin, uint8_t cv_led_pin);
 
     /// Initialize channel and underlying hardware.
     /// Makes a required tests, for example ADC, DAC and IO Expander tests.
@@ -486,7 +578,16 @@ public:
     const char *getBoardRevisionName();
 
     /// Returns features present (check ChannelFeatures) in board revision of this channel.
-    uint16_t getFeatures();
+    /// Inlined so that `getFeatures() & CH_FEATURE_*` folds to a constant
+    /// when all or none of the configured channels have the feature.
+    uint16_t getFeatures() {
+        return CH_FEATURES_ALL | (CH_FEATURES[index - 1] & CH_FEATURES_ANY);
+    }
+
+    /// Returns parameters of the model of this channel.
+    const ChannelParams &getParams() const {
+        return CH_PARAMS[index - 1];
+    }
 
     /// Returns currently set voltage limit
     float getVoltageLimit() const;
@@ -532,10 +633,6 @@ public:
     float getUSetUnbalanced() { return isVoltageBalanced() ? uBeforeBalancing : u.set; }
     float getISetUnbalanced() { return isCurrentBalanced() ? iBeforeBalancing : i.set; }
 
-    int getCurrentHistoryValuePosition() { return historyPosition; }
-    float getUMonHistory(int position) const { return uHistory[position]; }
-    float getIMonHistory(int position) const { return iHistory[position]; }
-
     void resetHistory();
 
     TriggerMode getVoltageTriggerMode();
@@ -544,6 +641,14 @@ public:
     TriggerMode getCurrentTriggerMode();
     void setCurrentTriggerMode(TriggerMode mode);
 
+    /// Generation of the channel settings, it is incremented every time
+    /// some of the channel settings is changed.
+    uint16_t getSettingsGeneration() const { return settingsGeneration; }
+
+    /// Should be called after channel settings are changed directly,
+    /// i.e. not through the Channel methods.
+    void onSettingsChanged() { ++settingsGeneration; }
+
 private:
     bool delayed_dp_off;
     uint32_t delayed_dp_off_start;
@@ -551,27 +656,20 @@ private:
     uint32_t outputEnableStartTime;
     uint32_t dpNegMonitoringTime;
 
-    float U_MIN;
-    float U_DEF;
-    float U_MAX;
-    float U_MAX_CONF;
-
-    float I_MIN;
-    float I_DEF;
-    float I_MAX;
-
     float uBeforeBalancing;
     float iBeforeBalancing;
 
     MaxCurrentLimitCause maxCurrentLimitCause;
 
+    uint16_t settingsGeneration;
+
     int negligibleAdcDiffForVoltage;
     int negligibleAdcDiffForCurrent;
 
-    float uHistory[CHANNEL_HISTORY_SIZE];
-    float iHistory[CHANNEL_HISTORY_SIZE];
-    int historyPosition;
-    uint32_t historyLastTick;
+    // SOA limits in integer units used by updateOperatingPoint
+    int32_t soaVin_mV;
+    int32_t soaPregCurr_mA;
+    int32_t soaPostregPtot_uW;
 
     float VOLTAGE_GND_OFFSET;
     float CURRENT_GND_OFFSET;
@@ -581,7 +679,15 @@ private:
     void protectionCheck(ProtectionValue &cpv);
     void protectionCheck();
 
+    /// ADC to real value and real value to DAC mappings for the voltage and current,
+    /// precomputed from `cal_conf` in `doCalibrationEnable`.
+    CalibrationMapping uMonCalMapping;
+    CalibrationMapping uSetCalMapping;
+    CalibrationMapping iMonCalMapping;
+    CalibrationMapping iSetCalMapping;
+
     void doCalibrationEnable(bool enable);
+    void prepareCalibrationMapping(const CalibrationValueConfiguration &valueConf, bool ignoreMid, const CalibrationValuePointConfiguration *extraPoints, uint8_t numExtraPoints, CalibrationMapping &monMapping, CalibrationMapping &setMapping);
     void calibrationFindVoltageRange(float minDac, float minVal, float minAdc, float maxDac, float maxVal, float maxAdc, float *min, float *max);
     void calibrationFindCurrentRange(float minDac, float minVal, float minAdc, float maxDac, float maxVal, float maxAdc, float *min, float *max);
     bool isVoltageCalibrationEnabled();
@@ -608,6 +714,7 @@ private:
     void doRemoteProgrammingEnable(bool enable);
 
     void lowRippleCheck(uint32_t tick_usec);
+    void updateOperatingPoint();
     void doLowRippleEnable(bool enable);
     void doLowRippleAutoEnable(bool enable);
 
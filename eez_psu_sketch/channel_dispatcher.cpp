@@ -21,12 +21,86 @@
 #include "bp.h"
 #include "temperature.h"
 #include "event_queue.h"
+#include "trigger.h"
 
 namespace eez {
 namespace psu {
 namespace channel_dispatcher {
 
 static Type g_channelCoupling = TYPE_NONE;
+static uint16_t g_generation;
+static LogicalChannel g_logicalChannel;
+
+/// Ratings of the logical channel depend on the coupling type and on the
+/// min/def/max values of both channels, which change only with calibration.
+static void updateLogicalChannelRatings() {
+    Channel &channel1 = Channel::get(0);
+    Channel &channel2 = Channel::get(1);
+
+    float uFactor = isSeries() ? 2.0f : 1.0f;
+    g_logicalChannel.uMin = uFactor * MAX(channel1.u.min, channel2.u.min);
+    g_logicalChannel.uDef = channel1.u.def + channel2.u.def;
+    g_logicalChannel.uMax = uFactor * MIN(channel1.u.max, channel2.u.max);
+
+    float iFactor = isParallel() ? 2.0f : 1.0f;
+    g_logicalChannel.iMin = iFactor * MAX(channel1.i.min, channel2.i.min);
+    g_logicalChannel.iDef = channel1.i.def + channel2.i.def;
+    g_logicalChannel.iMax = iFactor * MIN(channel1.i.max, channel2.i.max);
+}
+
+static void updateLogicalChannelMeasurement() {
+    Channel &channel1 = Channel::get(0);
+    Channel &channel2 = Channel::get(1);
+
+    if (isSeries()) {
+        g_logicalChannel.uMon = channel1.u.mon + channel2.u.mon;
+        g_logicalChannel.uMonDac = channel1.u.mon_dac + channel2.u.mon_dac;
+    } else {
+        g_logicalChannel.uMon = channel1.u.mon;
+        g_logicalChannel.uMonDac = channel1.u.mon_dac;
+    }
+
+    if (isParallel()) {
+        g_logicalChannel.iMon = channel1.i.mon + channel2.i.mon;
+        g_logicalChannel.iMonDac = channel1.i.mon_dac + channel2.i.mon_dac;
+    } else {
+        g_logicalChannel.iMon = channel1.i.mon;
+        g_logicalChannel.iMonDac = channel1.i.mon_dac;
+    }
+
+    g_logicalChannel.power_mW = (int32_t)(g_logicalChannel.uMon * g_logicalChannel.iMon * 1000);
+}
+
+/// Protection settings both channels get after the coupling is changed:
+/// CH1 is the master when tracked, otherwise the stricter setting wins.
+static void getSharedProtectionConfiguration(Channel::ChannelProtectionConfiguration &prot_conf, temperature::ProtectionConfiguration &otp_conf) {
+    Channel &channel1 = Channel::get(0);
+    Channel &channel2 = Channel::get(1);
+    temperature::ProtectionConfiguration &otp1 = temperature::sensors[temp_sensor::CH1].prot_conf;
+    temperature::ProtectionConfiguration &otp2 = temperature::sensors[temp_sensor::CH2].prot_conf;
+
+    prot_conf = channel1.prot_conf;
+    otp_conf = otp1;
+
+    if (isTracked()) {
+        return;
+    }
+
+    prot_conf.flags.u_state = channel1.prot_conf.flags.u_state || channel2.prot_conf.flags.u_state ? 1 : 0;
+    prot_conf.u_level = MIN(channel1.prot_conf.u_level, channel2.prot_conf.u_level);
+    prot_conf.u_delay = MIN(channel1.prot_conf.u_delay, channel2.prot_conf.u_delay);
+
+    prot_conf.flags.i_state = channel1.prot_conf.flags.i_state || channel2.prot_conf.flags.i_state ? 1 : 0;
+    prot_conf.i_delay = MIN(channel1.prot_conf.i_delay, channel2.prot_conf.i_delay);
+
+    prot_conf.flags.p_state = channel1.prot_conf.flags.p_state || channel2.prot_conf.flags.p_state ? 1 : 0;
+    prot_conf.p_level = MIN(channel1.prot_conf.p_level, channel2.prot_conf.p_level);
+    prot_conf.p_delay = MIN(channel1.prot_conf.p_delay, channel2.prot_conf.p_delay);
+
+    otp_conf.state = otp1.state || otp2.state;
+    otp_conf.level = MIN(otp1.level, otp2.level);
+    otp_conf.delay = MIN(otp1.delay, otp2.delay);
+}
 
 bool setType(Type value) {
     if (g_channelCoupling != value) {
@@ -41,6 +115,13 @@ bool setType(Type value) {
         }
 
         g_channelCoupling = value;
+        ++g_generation;
+
+        updateLogicalChannelRatings();
+
+        Channel::ChannelProtectionConfiguration prot_conf;
+        temperature::ProtectionConfiguration otp_conf;
+        getSharedProtectionConfiguration(prot_conf, otp_conf);
 
         for (int i = 0; i < 2; ++i) {
             if (i < CH_NUM) {
@@ -57,6 +138,15 @@ bool setType(Type value) {
                         channel.lowRippleAutoEnable(false);
                     }
 
+                    persist_conf::BlockHeader header = channel.prot_conf.header;
+                    channel.prot_conf = prot_conf;
+                    channel.prot_conf.header = header;
+
+                    temperature::ProtectionConfiguration &otp = temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf;
+                    otp.state = otp_conf.state;
+                    otp.level = otp_conf.level;
+                    otp.delay = otp_conf.delay;
+
                     if (isTracked()) {
                         if (i != 0) {
                             Channel &channel1 = Channel::get(0);
@@ -66,26 +156,6 @@ bool setType(Type value) {
 
                             channel.setCurrentLimit(channel1.getCurrentLimit());
                             channel.setCurrent(channel1.i.set);
-
-                            channel.prot_conf.flags.u_state = channel1.prot_conf.flags.u_state;
-                            channel.prot_conf.u_level = channel1.prot_conf.u_level;
-                            channel.prot_conf.u_delay = channel1.prot_conf.u_delay;
-
-                            channel.prot_conf.flags.i_state = channel1.prot_conf.flags.i_state;
-                            channel.prot_conf.i_delay = channel1.prot_conf.i_delay;
-
-                            channel.prot_conf.flags.p_state = channel1.prot_conf.flags.p_state;
-                            channel.prot_conf.p_level = channel1.prot_conf.p_level;
-                            channel.prot_conf.p_delay = channel1.prot_conf.p_delay;
-
-                            temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.state =
-                                temperature::sensors[temp_sensor::CH1].prot_conf.state;
-
-                            temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.level =
-                                temperature::sensors[temp_sensor::CH1].prot_conf.level;
-            
-                            temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.delay =
-                                temperature::sensors[temp_sensor::CH1].prot_conf.delay;
                         } else {
                             channel.setVoltageLimit(MIN(Channel::get(0).getVoltageLimit(), Channel::get(1).getVoltageLimit()));
                             channel.setCurrentLimit(MIN(Channel::get(0).getCurrentLimit(), Channel::get(1).getCurrentLimit()));
@@ -97,29 +167,6 @@ bool setType(Type value) {
                         channel.setCurrent(getIMin(channel));
                         channel.setCurrentLimit(MIN(Channel::get(0).getCurrentLimit(), Channel::get(1).getCurrentLimit()));
 
-                        channel.prot_conf.flags.u_state = Channel::get(0).prot_conf.flags.u_state || Channel::get(1).prot_conf.flags.u_state ? 1 : 0;
-                        channel.prot_conf.u_level = MIN(Channel::get(0).prot_conf.u_level, Channel::get(1).prot_conf.u_level);
-                        channel.prot_conf.u_delay = MIN(Channel::get(0).prot_conf.u_delay, Channel::get(1).prot_conf.u_delay);
-
-                        channel.prot_conf.flags.i_state = Channel::get(0).prot_conf.flags.i_state || Channel::get(1).prot_conf.flags.i_state ? 1 : 0;
-                        channel.prot_conf.i_delay = MIN(Channel::get(0).prot_conf.i_delay, Channel::get(1).prot_conf.i_delay);
-
-                        channel.prot_conf.flags.p_state = Channel::get(0).prot_conf.flags.p_state || Channel::get(1).prot_conf.flags.p_state ? 1 : 0;
-                        channel.prot_conf.p_level = MIN(Channel::get(0).prot_conf.p_level, Channel::get(1).prot_conf.p_level);
-                        channel.prot_conf.p_delay = MIN(Channel::get(0).prot_conf.p_delay, Channel::get(1).prot_conf.p_delay);
-
-                        temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.state =
-                            temperature::sensors[temp_sensor::CH1].prot_conf.state ||
-                            temperature::sensors[temp_sensor::CH2].prot_conf.state ? 1 : 0;
-
-                        temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.level =
-                            MIN(temperature::sensors[temp_sensor::CH1].prot_conf.level,
-                                temperature::sensors[temp_sensor::CH2].prot_conf.level);
-            
-                        temperature::sensors[temp_sensor::CH1 + channel.index - 1].prot_conf.delay =
-                            MIN(temperature::sensors[temp_sensor::CH1].prot_conf.delay,
-                                temperature::sensors[temp_sensor::CH2].prot_conf.delay);
-
 #ifdef EEZ_PSU_SIMULATOR
                         channel.simulator.setLoadEnabled(false);
                         channel.simulator.setLoad(Channel::get(0).simulator.getLoad());
@@ -165,6 +212,27 @@ Type getType() {
     return g_channelCoupling;
 }
 
+const LogicalChannel &getLogicalChannel() {
+    return g_logicalChannel;
+}
+
+void onChannelSample(Channel &channel) {
+    if (g_channelCoupling != TYPE_NONE && channel.index <= 2) {
+        updateLogicalChannelMeasurement();
+    }
+}
+
+void onChannelChanged(Channel &channel) {
+    if (g_channelCoupling != TYPE_NONE && channel.index <= 2) {
+        updateLogicalChannelRatings();
+        updateLogicalChannelMeasurement();
+    }
+}
+
+uint16_t getGeneration() {
+    return g_generation;
+}
+
 float getUSet(const Channel &channel) { 
     if (isSeries()) {
         return Channel::get(0).u.set + Channel::get(1).u.set;
@@ -181,21 +249,21 @@ float getUSetUnbalanced(const Channel &channel) {
 
 float getUMon(const Channel &channel) { 
     if (isSeries()) {
-        return Channel::get(0).u.mon + Channel::get(1).u.mon;
+        return g_logicalChannel.uMon;
     }
     return channel.u.mon; 
 }
 
 float getUMonHistory(const Channel &channel, int position) { 
     if (isSeries()) {
-        return Channel::get(0).getUMonHistory(position) + Channel::get(1).getUMonHistory(position);
+        return Channel::get(0).trend.getSampleU(position) + Channel::get(1).trend.getSampleU(position);
     }
-    return channel.getUMonHistory(position); 
+    return channel.trend.getSampleU(position); 
 }
 
 float getUMonDac(const Channel &channel) { 
     if (isSeries()) {
-        return Channel::get(0).u.mon_dac + Channel::get(1).u.mon_dac;
+        return g_logicalChannel.uMonDac;
     }
     return channel.u.mon_dac; 
 }
@@ -217,26 +285,22 @@ float getUMaxLimit(const Channel &channel) {
 }
 
 float getUMin(const Channel &channel) {
-    if (isSeries()) {
-        return 2 * MAX(Channel::get(0).u.min, Channel::get(1).u.min);
-    } else if (isParallel() || isTracked()) {
-        return MAX(Channel::get(0).u.min, Channel::get(1).u.min);
+    if (g_channelCoupling != TYPE_NONE) {
+        return g_logicalChannel.uMin;
     }
     return channel.u.min;
 }
 
 float getUDef(const Channel &channel) {
     if (isSeries()) {
-        return Channel::get(0).u.def + Channel::get(1).u.def;
+        return g_logicalChannel.uDef;
     }
     return channel.u.def;
 }
 
 float getUMax(const Channel &channel) {
-    if (isSeries()) {
-        return 2 * MIN(Channel::get(0).u.max, Channel::get(1).u.max);
-    } else if (isParallel() || isTracked()) {
-        return MIN(Channel::get(0).u.max, Channel::get(1).u.max);
+    if (g_channelCoupling != TYPE_NONE) {
+        return g_logicalChannel.uMax;
     }
     return channel.u.max;
 }
@@ -273,6 +337,8 @@ void setVoltageLimit(Channel &channel, float limit) {
 }
 
 void setOvpParameters(Channel &channel, int state, float level, float delay) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         float coupledLevel = isSeries() ? level / 2 : level;
 
@@ -291,6 +357,8 @@ void setOvpParameters(Channel &channel, int state, float level, float delay) {
 }
 
 void setOvpState(Channel &channel, int state) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         Channel::get(0).prot_conf.flags.u_state = state;
         Channel::get(1).prot_conf.flags.u_state = state;
@@ -334,21 +402,21 @@ float getISetUnbalanced(const Channel &channel) {
 
 float getIMon(const Channel &channel) { 
     if (isParallel()) {
-        return Channel::get(0).i.mon + Channel::get(1).i.mon;
+        return g_logicalChannel.iMon;
     }
     return channel.i.mon; 
 }
 
 float getIMonHistory(const Channel &channel, int position) { 
     if (isParallel()) {
-        return Channel::get(0).getIMonHistory(position) + Channel::get(1).getIMonHistory(position);
+        return Channel::get(0).trend.getSampleI(position) + Channel::get(1).trend.getSampleI(position);
     }
-    return channel.getIMonHistory(position); 
+    return channel.trend.getSampleI(position); 
 }
 
 float getIMonDac(const Channel &channel) { 
     if (isParallel()) {
-        return Channel::get(0).i.mon_dac + Channel::get(1).i.mon_dac;
+        return g_logicalChannel.iMonDac;
     }
     return channel.i.mon_dac; 
 }
@@ -370,26 +438,22 @@ float getIMaxLimit(const Channel &channel) {
 }
 
 float getIMin(const Channel &channel) {
-    if (isParallel()) {
-        return 2 * MAX(Channel::get(0).i.min, Channel::get(1).i.min);
-    } else if (isSeries() || isTracked()) {
-        return MAX(Channel::get(0).i.min, Channel::get(1).i.min);
+    if (g_channelCoupling != TYPE_NONE) {
+        return g_logicalChannel.iMin;
     }
     return channel.i.min;
 }
 
 float getIDef(const Channel &channel) {
     if (isParallel()) {
-        return Channel::get(0).i.def + Channel::get(1).i.def;
+        return g_logicalChannel.iDef;
     }
     return channel.i.def;
 }
 
 float getIMax(const Channel &channel) {
-    if (isParallel()) {
-        return 2 * MIN(Channel::get(0).i.max, Channel::get(1).i.max);
-    } else if (isSeries() || isTracked()) {
-        return MIN(Channel::get(0).i.max, Channel::get(1).i.max);
+    if (g_channelCoupling != TYPE_NONE) {
+        return g_logicalChannel.iMax;
     }
     return channel.i.max;
 }
@@ -419,6 +483,8 @@ void setCurrentLimit(Channel &channel, float limit) {
 }
 
 void setOcpParameters(Channel &channel, int state, float delay) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         Channel::get(0).prot_conf.flags.i_state = state;
         Channel::get(0).prot_conf.i_delay = delay;
@@ -432,6 +498,8 @@ void setOcpParameters(Channel &channel, int state, float delay) {
 }
 
 void setOcpState(Channel &channel, int state) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         Channel::get(0).prot_conf.flags.i_state = state;
         Channel::get(1).prot_conf.flags.i_state = state;
@@ -462,9 +530,9 @@ float getPowerMinLimit(const Channel& channel) {
 
 float getPowerMaxLimit(const Channel& channel) {
     if (isCoupled()) {
-        return 2 * MIN(Channel::get(0).PTOT, Channel::get(1).PTOT);
+        return 2 * MIN(Channel::get(0).getParams().PTOT, Channel::get(1).getParams().PTOT);
     }
-    return channel.PTOT;
+    return channel.getParams().PTOT;
 }
 
 float getPowerDefaultLimit(const Channel& channel) {
@@ -492,26 +560,28 @@ void setPowerLimit(Channel &channel, float limit) {
 
 float getOppMinLevel(Channel &channel) {
     if (isCoupled()) {
-        return 2 * MAX(Channel::get(0).OPP_MIN_LEVEL, Channel::get(1).OPP_MIN_LEVEL);
+        return 2 * MAX(Channel::get(0).getParams().OPP_MIN_LEVEL, Channel::get(1).getParams().OPP_MIN_LEVEL);
     }
-    return channel.OPP_MIN_LEVEL;
+    return channel.getParams().OPP_MIN_LEVEL;
 }
 
 float getOppMaxLevel(Channel &channel) {
     if (isCoupled()) {
-        return 2 * MIN(Channel::get(0).OPP_MAX_LEVEL, Channel::get(1).OPP_MAX_LEVEL);
+        return 2 * MIN(Channel::get(0).getParams().OPP_MAX_LEVEL, Channel::get(1).getParams().OPP_MAX_LEVEL);
     }
-    return channel.OPP_MAX_LEVEL;
+    return channel.getParams().OPP_MAX_LEVEL;
 }
 
 float getOppDefaultLevel(Channel &channel) {
     if (isCoupled()) {
-        return Channel::get(0).OPP_DEFAULT_LEVEL + Channel::get(1).OPP_DEFAULT_LEVEL;
+        return Channel::get(0).getParams().OPP_DEFAULT_LEVEL + Channel::get(1).getParams().OPP_DEFAULT_LEVEL;
     }
-    return channel.OPP_DEFAULT_LEVEL;
+    return channel.getParams().OPP_DEFAULT_LEVEL;
 }
 
 void setOppParameters(Channel &channel, int state, float level, float delay) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         Channel::get(0).prot_conf.flags.p_state = state;
         Channel::get(0).prot_conf.p_level = isCoupled() ? level / 2 : level;
@@ -528,6 +598,8 @@ void setOppParameters(Channel &channel, int state, float level, float delay) {
 }
 
 void setOppState(Channel &channel, int state) {
+    ++g_generation;
+
     if (isCoupled() || isTracked()) {
         Channel::get(0).prot_conf.flags.p_state = state;
         Channel::get(1).prot_conf.flags.p_state = state;
@@ -564,6 +636,10 @@ void outputEnable(Channel& channel, bool enable) {
     } else {
         channel.outputEnable(enable);
     }
+
+    if (enable && channel.isOutputEnabled()) {
+        trigger::outputPulse(trigger::OUTPUT_SOURCE_OUTPUT);
+    }
 }
 
 void remoteSensingEnable(Channel& channel, bool enable) {
@@ -38,6 +38,39 @@ enum Type {
 bool setType(Type value);
 Type getType();
 
+/// Generation of the channel coupling settings, it is incremented every time
+/// coupling type or protection state of the coupled channels is changed.
+uint16_t getGeneration();
+
+/// Combined view of CH1 and CH2 while they are coupled or tracked. Ratings
+/// are resolved when coupling or the limits of one of the two channels change
+/// and the measured values are refreshed every time one of the two channels
+/// gets an ADC sample.
+struct LogicalChannel {
+    float uMon;
+    float uMonDac;
+    float iMon;
+    float iMonDac;
+    /// uMon * iMon in mW
+    int32_t power_mW;
+
+    float uMin;
+    float uDef;
+    float uMax;
+    float iMin;
+    float iDef;
+    float iMax;
+};
+
+const LogicalChannel &getLogicalChannel();
+
+/// Called by the channel after it has processed an ADC sample.
+void onChannelSample(Channel &channel);
+
+/// Called by the channel after its min/def/max values were changed
+/// (calibration enabled or disabled) or its DAC monitor values were reset.
+void onChannelChanged(Channel &channel);
+
 inline bool isCoupled() { return getType() == TYPE_PARALLEL || getType() == TYPE_SERIES; }
 inline bool isParallel() { return getType() == TYPE_PARALLEL; }
 inline bool isSeries() { return getType() == TYPE_SERIES; }
@@ -34,6 +34,15 @@
 /// SCPI TCP server port.
 #define TCP_PORT 5025
 
+/// UDP port on which the discovery service answers discovery and status requests.
+#define DISCOVERY_UDP_PORT 5025
+
+/// UDP port to which the periodic status frame is broadcast.
+#define STATUS_BROADCAST_UDP_PORT 5026
+
+/// Maximum status broadcast period in seconds.
+#define STATUS_BROADCAST_PERIOD_MAX 600.0f
+
 /// Name of the DAC chip.
 #define DAC_NAME "DAC8552"
 
@@ -92,6 +101,17 @@
 /// and real mid value during calibration.
 #define CALIBRATION_MID_TOLERANCE_PERCENT 1.0f
 
+/// Maximum number of additional calibration points, between min and max,
+/// for the voltage and for the current.
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define CALIBRATION_MAX_EXTRA_POINTS 1
+#else
+#define CALIBRATION_MAX_EXTRA_POINTS 4
+#endif
+
+/// Maximum number of calibration points: min, mid, max and additional points.
+#define CALIBRATION_MAX_POINTS (3 + CALIBRATION_MAX_EXTRA_POINTS)
+
 /// Number of digits after decimal point
 /// in float to string conversion.
 #define FLOAT_TO_STR_NUM_DECIMAL_DIGITS 2
@@ -157,6 +177,10 @@
 /// Size of SCPI parser error queue.
 #define SCPI_PARSER_ERROR_QUEUE_SIZE 20
 
+/// Min. period (in milliseconds) between two measurement
+/// change notifications sent to the same SCPI connection.
+#define NOTIFY_MEAS_MIN_INTERVAL_MS 50
+
 /// Since we are not using timer, but ADC interrupt for the OVP and
 /// OCP delay measuring there will be some error (size of which
 /// depends on ADC_SPS value). You can use the following value, which
@@ -191,8 +215,8 @@
 /// Minimal temperature (in oC) for sensor to be declared as valid.
 #define TEMP_SENSOR_MIN_VALID_TEMPERATURE -5
 
-/// Interval at which fan speed should be adjusted
-#define FAN_SPEED_ADJUSTMENT_INTERVAL 10000
+/// Interval (in ms) at which fan controller adjusts fan speed
+#define FAN_SPEED_ADJUSTMENT_INTERVAL 1000
 
 /// Interval at which fan speed should be measured
 #define FAN_SPEED_MEASURMENT_INTERVAL 5000
@@ -200,6 +224,30 @@
 /// Fan switch-on temperature (in oC)
 #define FAN_MIN_TEMP 55
 
+/// Temperature (in oC) of the hottest channel the fan controller is trying to keep.
+#define FAN_PID_TARGET_TEMP 60
+
+/// Fan controller proportional gain, PWM per oC above the target.
+#define FAN_PID_KP 12.0f
+
+/// Fan controller integral gain, PWM per oC above the target per adjustment interval.
+#define FAN_PID_KI 0.5f
+
+/// Fan controller derivative gain, PWM per oC of temperature rise per adjustment interval.
+#define FAN_PID_KD 40.0f
+
+/// Fan controller feed-forward, PWM per watt dissipated in the channel output stages.
+#define FAN_FF_PWM_PER_WATT 1.0f
+
+/// Time (in us) for the fan to settle when PWM is set to max. before RPM is measured.
+#define FAN_RPM_SETTLE_TIME 2000
+
+/// Number of the fan sense periods over which RPM is measured.
+#define FAN_RPM_MEASURE_PERIODS 4
+
+/// Min. expected fan RPM at max. PWM, RPM measurement times out (and fan test fails) if fan is slower.
+#define FAN_MIN_RPM 1000
+
 /// Max. allowed temperature (in oC), if it stays more then FAN_MAX_TEMP_DELAY seconds then main power will be turned off.
 #define FAN_MAX_TEMP 75
 
@@ -255,6 +303,11 @@
 /// See DP_NEG_LEV.
 #define DP_NEG_DELAY 5 // 5 s
 
+/// Low ripple mode is entered only when the post-regulator current and
+/// dissipation are this many percent below their SOA limits, and left as soon
+/// as a limit is exceeded.
+#define LOW_RIPPLE_SOA_HYSTERESIS 5
+
 /// Replace standard SPI transactions implementation with in-house implementation,
 /// It is more simple version where all interrupts are disabled during SPI transactions.
 /// We had some problems (WATCHDOG, ADC timeout and EEPROM errros) with SPI in the
@@ -264,6 +317,15 @@
 
 #define CHANNEL_HISTORY_SIZE 140
 
+/// Number of the 1 second and 1 minute buckets in the channel trend history.
+#ifdef EEZ_PSU_ARDUINO_MEGA
+#define TREND_SECONDS_SIZE 10
+#define TREND_MINUTES_SIZE 10
+#else
+#define TREND_SECONDS_SIZE 120
+#define TREND_MINUTES_SIZE 60
+#endif
+
 #define GUI_YT_VIEW_RATE_DEFAULT 0.1f
 #define GUI_YT_VIEW_RATE_MIN 0.02f
 #define GUI_YT_VIEW_RATE_MAX 300.0f
@@ -272,4 +334,11 @@
 
 #define LIST_DWELL_MIN 0.0001f 
 #define LIST_DWELL_MAX 65535.0f
-#define LIST_DWELL_DEF 0.1f
\ No newline at end of file
+#define LIST_DWELL_DEF 0.1f
+
+/// If trigger delay expires within this many microseconds,
+/// trigger is applied after busy waiting for the exact moment.
+#define TRIGGER_DELAY_SPIN_TIME_US 2000
+
+/// Width of the pulse emitted on the SYNC pin when it is used as trigger output.
+#define TRIGGER_OUTPUT_PULSE_WIDTH_US 10
\ No newline at end of file
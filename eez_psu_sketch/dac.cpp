@@ -156,11 +156,11 @@ bool DigitalAnalogConverter::test() {
 ////////////////////////////////////////////////////////////////////////////////
 
 void DigitalAnalogConverter::set_voltage(float value) {
-    set_value(DATA_BUFFER_A, util::remap(value, channel.U_MIN, (float)DAC_MIN, channel.U_MAX, (float)DAC_MAX));
+    set_value(DATA_BUFFER_A, util::remap(value, channel.getParams().U_MIN, (float)DAC_MIN, channel.getParams().U_MAX, (float)DAC_MAX));
 }
 
 void DigitalAnalogConverter::set_current(float value) {
-    set_value(DATA_BUFFER_B, util::remap(value, channel.I_MIN, (float)DAC_MIN, channel.I_MAX, (float)DAC_MAX));
+    set_value(DATA_BUFFER_B, util::remap(value, channel.getParams().I_MIN, (float)DAC_MIN, channel.getParams().I_MAX, (float)DAC_MAX));
 }
 
 }
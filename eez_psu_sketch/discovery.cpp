@@ -0,0 +1,198 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+
+#if OPTION_ETHERNET
+
+#if defined(EEZ_PSU_SIMULATOR) || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R1B9
+#include <UIPEthernet.h>
+#include <UIPUdp.h>
+#elif EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+#include <Ethernet2.h>
+#include <EthernetUdp2.h>
+#endif
+
+#include "ethernet.h"
+#include "discovery.h"
+#include "persist_conf.h"
+#include "temperature.h"
+
+namespace eez {
+namespace psu {
+namespace discovery {
+
+static const size_t REQUEST_BUFFER_SIZE = 32;
+static const size_t STATUS_FRAME_SIZE = sizeof(StatusFrameHeader) + CH_NUM * sizeof(StatusFrameChannel) + temp_sensor::NUM_TEMP_SENSORS * sizeof(float);
+
+static const char DISCOVER_REQUEST[] PROGMEM = "EEZ PSU DISCOVER";
+static const char STATUS_REQUEST[] PROGMEM = "EEZ PSU STATUS";
+
+static EthernetUDP g_udp;
+static bool g_udpOk;
+
+static uint32_t g_sequence;
+static uint32_t g_lastBroadcastTick;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool isRequest(const char *request, size_t requestLength, const char *expected PROGMEM) {
+    size_t expectedLength = strlen_P(expected);
+    return requestLength >= expectedLength && strncmp_P(request, expected, expectedLength) == 0;
+}
+
+static void sendPacket(IPAddress ip, uint16_t port, const uint8_t *data, size_t size) {
+    SPI_beginTransaction(ETHERNET_SPI);
+    if (g_udp.beginPacket(ip, port)) {
+        g_udp.write(data, size);
+        g_udp.endPacket();
+    }
+    SPI_endTransaction();
+}
+
+static void sendDiscoveryReply(IPAddress ip, uint16_t port) {
+    char reply[128];
+
+    uint32_t ipAddress = ethernet::getIpAddress();
+    uint8_t *bytes = (uint8_t *)&ipAddress;
+    snprintf_P(reply, sizeof(reply), PSTR("%s,%s,%s,%s,%d.%d.%d.%d,%d\r\n"),
+        MANUFACTURER, getModelName(), persist_conf::devConf.serialNumber, FIRMWARE,
+        (int)bytes[0], (int)bytes[1], (int)bytes[2], (int)bytes[3], (int)TCP_PORT);
+    reply[sizeof(reply) - 1] = 0;
+
+    sendPacket(ip, port, (const uint8_t *)reply, strlen(reply));
+}
+
+static void sendStatusFrame(IPAddress ip, uint16_t port) {
+    // Frame is a byte buffer without any alignment guarantee, so the records
+    // are filled in the local variables and copied into it.
+    uint8_t frame[STATUS_FRAME_SIZE];
+    uint8_t *p = frame;
+
+    StatusFrameHeader header;
+    header.magic = STATUS_FRAME_MAGIC;
+    header.version = STATUS_FRAME_VERSION;
+    header.numChannels = CH_NUM;
+    header.numTemperatures = temp_sensor::NUM_TEMP_SENSORS;
+    header.reserved = 0;
+    header.sequence = g_sequence++;
+
+    scpi_t *context = &ethernet::scpi_context;
+    header.stb = (uint16_t)SCPI_RegGet(context, SCPI_REG_STB);
+    header.esr = (uint16_t)SCPI_RegGet(context, SCPI_REG_ESR);
+    header.oper = (uint16_t)scpi::reg_get(context, scpi::SCPI_PSU_REG_OPER_COND);
+    header.ques = (uint16_t)scpi::reg_get(context, scpi::SCPI_PSU_REG_QUES_COND);
+
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel &channel = Channel::get(i);
+
+        uint16_t flags = 0;
+        if (channel.isOk()) flags |= CHANNEL_FLAG_OK;
+        if (channel.isOutputEnabled()) flags |= CHANNEL_FLAG_OUTPUT_ENABLED;
+        if (channel.isCvMode()) flags |= CHANNEL_FLAG_CV_MODE;
+        if (channel.isCcMode()) flags |= CHANNEL_FLAG_CC_MODE;
+        if (channel.ovp.flags.tripped) flags |= CHANNEL_FLAG_OVP_TRIPPED;
+        if (channel.ocp.flags.tripped) flags |= CHANNEL_FLAG_OCP_TRIPPED;
+        if (channel.opp.flags.tripped) flags |= CHANNEL_FLAG_OPP_TRIPPED;
+        if (temperature::isAnySensorTripped(&channel)) flags |= CHANNEL_FLAG_OTP_TRIPPED;
+        if (channel.isRemoteSensingEnabled()) flags |= CHANNEL_FLAG_REMOTE_SENSING;
+        if (channel.isRemoteProgrammingEnabled()) flags |= CHANNEL_FLAG_REMOTE_PROGRAMMING;
+        if (channel.isLowRippleEnabled()) flags |= CHANNEL_FLAG_LOW_RIPPLE;
+
+        StatusFrameChannel channelRecord;
+        channelRecord.u = channel.u.mon;
+        channelRecord.i = channel.i.mon;
+        channelRecord.p = channel.op.power_mW / 1000.0f;
+        channelRecord.flags = flags;
+        channelRecord.reserved = 0;
+
+        memcpy(p, &channelRecord, sizeof(channelRecord));
+        p += sizeof(channelRecord);
+    }
+
+    for (int i = 0; i < temp_sensor::NUM_TEMP_SENSORS; ++i) {
+        temperature::TempSensorTemperature &sensor = temperature::sensors[i];
+        float temperatureRecord = sensor.isInstalled() ? sensor.temperature : NAN;
+
+        memcpy(p, &temperatureRecord, sizeof(temperatureRecord));
+        p += sizeof(temperatureRecord);
+    }
+
+    sendPacket(ip, port, frame, sizeof(frame));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void init() {
+    SPI_beginTransaction(ETHERNET_SPI);
+    g_udpOk = g_udp.begin(DISCOVERY_UDP_PORT) ? true : false;
+    SPI_endTransaction();
+
+    if (!g_udpOk) {
+        DebugTrace("Discovery service not started!");
+        return;
+    }
+
+    DebugTraceF("Discovery service listening on UDP port %d", (int)DISCOVERY_UDP_PORT);
+}
+
+void tick(uint32_t tick_usec) {
+    if (!g_udpOk) {
+        return;
+    }
+
+    SPI_beginTransaction(ETHERNET_SPI);
+    int size = g_udp.parsePacket();
+    SPI_endTransaction();
+
+    if (size > 0) {
+        char request[REQUEST_BUFFER_SIZE];
+
+        SPI_beginTransaction(ETHERNET_SPI);
+        int requestLength = g_udp.read((uint8_t *)request, sizeof(request));
+        IPAddress remoteIP = g_udp.remoteIP();
+        uint16_t remotePort = g_udp.remotePort();
+        SPI_endTransaction();
+
+        if (requestLength > 0) {
+            if (isRequest(request, requestLength, DISCOVER_REQUEST)) {
+                sendDiscoveryReply(remoteIP, remotePort);
+            }
+            else if (isRequest(request, requestLength, STATUS_REQUEST)) {
+                sendStatusFrame(remoteIP, remotePort);
+            }
+        }
+    }
+
+    uint16_t period = persist_conf::devConf2.statusBroadcastPeriod;
+    if (period) {
+        if (tick_usec - g_lastBroadcastTick >= period * 100000UL) {
+            g_lastBroadcastTick = tick_usec;
+            sendStatusFrame(IPAddress(255, 255, 255, 255), STATUS_BROADCAST_UDP_PORT);
+        }
+    }
+}
+
+}
+}
+} // namespace eez::psu::discovery
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+/// UDP discovery and status broadcast service.
+///
+/// Listens on DISCOVERY_UDP_PORT and answers to the following requests:
+///  - "EEZ PSU DISCOVER": replies with the "<manufacturer>,<model>,<serial>,<firmware>,<ip>,<tcp port>" text,
+///  - "EEZ PSU STATUS": replies with the binary status frame.
+/// If status broadcast period is set (see SYSTem:COMMunicate:LAN:STATus:PERiod) the status frame is
+/// periodically broadcast to the STATUS_BROADCAST_UDP_PORT.
+namespace discovery {
+
+static const uint32_t STATUS_FRAME_MAGIC = 0x5A5A4545; // "EEZZ"
+static const uint8_t STATUS_FRAME_VERSION = 1;
+
+/// Status frame header, followed by numChannels StatusFrameChannel records
+/// and numTemperatures float temperatures (NaN if sensor is not installed).
+/// All values are little endian and the layout has no padding.
+struct StatusFrameHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t numChannels;
+    uint8_t numTemperatures;
+    uint8_t reserved;
+    uint32_t sequence;
+    uint16_t stb;
+    uint16_t esr;
+    uint16_t oper;
+    uint16_t ques;
+};
+
+enum StatusFrameChannelFlags {
+    CHANNEL_FLAG_OK = 1 << 0,
+    CHANNEL_FLAG_OUTPUT_ENABLED = 1 << 1,
+    CHANNEL_FLAG_CV_MODE = 1 << 2,
+    CHANNEL_FLAG_CC_MODE = 1 << 3,
+    CHANNEL_FLAG_OVP_TRIPPED = 1 << 4,
+    CHANNEL_FLAG_OCP_TRIPPED = 1 << 5,
+    CHANNEL_FLAG_OPP_TRIPPED = 1 << 6,
+    CHANNEL_FLAG_OTP_TRIPPED = 1 << 7,
+    CHANNEL_FLAG_REMOTE_SENSING = 1 << 8,
+    CHANNEL_FLAG_REMOTE_PROGRAMMING = 1 << 9,
+    CHANNEL_FLAG_LOW_RIPPLE = 1 << 10
+};
+
+struct StatusFrameChannel {
+    float u;
+    float i;
+    float p;
+    uint16_t flags;
+    uint16_t reserved;
+};
+
+void init();
+void tick(uint32_t tick_usec);
+
+}
+}
+} // namespace eez::psu::discovery
@@ -25,6 +25,8 @@ namespace eeprom {
 
 psu::TestResult g_testResult = psu::TEST_FAILED;
 
+static bool g_writeInProgress;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void send_address(uint16_t address) {
@@ -33,6 +35,8 @@ void send_address(uint16_t address) {
 }
 
 void read_chunk(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    wait_write_end();
+
     SPI_beginTransaction(AT25256B_SPI);
 
     digitalWrite(EEPROM_SELECT, LOW);  // select chip
@@ -53,18 +57,6 @@ void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
     for (uint16_t i = 0; i < buffer_size; i += 64) {
         read_chunk(buffer + i, MIN(buffer_size - i, 64), address + i);
     }
-
-    delay(1);
-
-    uint8_t verifyBuffer[256];
-    uint16_t verifySize = MIN(buffer_size, sizeof(verifyBuffer));
-    for (uint16_t i = 0; i < verifySize; i += 64) {
-        read_chunk(verifyBuffer + i, MIN(buffer_size - i, 64), address + i);
-    }
-
-    if (memcmp(buffer, verifyBuffer, verifySize)) {
-        DebugTrace("EEPROM read verify error");
-    }
 }
 
 bool is_write_in_progress() {
@@ -77,7 +69,9 @@ bool is_write_in_progress() {
     return (data & (1 << 0));
 }
 
-void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+void begin_write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    wait_write_end();
+
     SPI_beginTransaction(AT25256B_SPI);
 
     // enable writing
@@ -98,11 +92,18 @@ void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address)
     digitalWrite(EEPROM_SELECT, HIGH); // release chip
     SPI_endTransaction();
 
+    g_writeInProgress = true;
+}
+
+bool end_write_chunk() {
+    bool result = true;
+
     uint32_t s = micros();
     while (is_write_in_progress()) {
         uint32_t e = micros();
         if (e - s > 3000) {
             DebugTrace("EEPROM write failure!");
+            result = false;
             break;
         }
     }
@@ -113,33 +114,37 @@ void write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address)
     SPI.transfer(WRDI);                // send write disable command
     digitalWrite(EEPROM_SELECT, HIGH); // deselect chip
     SPI_endTransaction();
-}
 
-static uint8_t *buffer_verify;
-static uint16_t buffer_verify_size;
+    g_writeInProgress = false;
 
-bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
-    for (uint16_t i = 0; i < buffer_size; i += 64) {
-        write_chunk(buffer + i, MIN(buffer_size - i, 64), address + i);
-    }
+    return result;
+}
 
-    if (!buffer_verify || buffer_size > buffer_verify_size) {
-        if (buffer_verify) {
-            free(buffer_verify);
-        }
-        buffer_verify = (uint8_t *)malloc(buffer_size);
-        buffer_verify_size = buffer_size;
-        //DebugTraceF("buffer_verify_size = %u", buffer_verify_size);
+void wait_write_end() {
+    if (g_writeInProgress) {
+        end_write_chunk();
     }
+}
 
-    read(buffer_verify, buffer_size, address);
+bool write_chunk(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    begin_write_chunk(buffer, buffer_size, address);
+    return end_write_chunk();
+}
 
-    if (memcmp(buffer, buffer_verify, buffer_size) == 0) {
-        return true;
+/// There is no read back verification after write, persist_conf keeps multiple
+/// copies of every block and on load picks the newest one with the valid checksum.
+bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    bool result = true;
+    for (uint16_t i = 0; i < buffer_size; i += 64) {
+        if (!write_chunk(buffer + i, MIN(buffer_size - i, 64), address + i)) {
+            result = false;
+        }
     }
+    return result;
+}
 
-    DebugTrace("EEPROM write verify failed!");
-    return false;
+void writeAsync(const uint8_t *buffer, uint16_t buffer_size, uint16_t address) {
+    begin_write_chunk(buffer, buffer_size, address);
 }
 
 void init() {
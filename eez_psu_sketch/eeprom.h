@@ -25,41 +25,65 @@
 |Address|Size|Description                               |
 |-------|----|------------------------------------------|
 |0      |  64|Not used                                  |
-|64     |  24|[Total ON-time counter](#ontime-counter)  |
-|128    |  24|[CH1 ON-time counter](#ontime-counter)    |
-|192    |  24|[CH2 ON-time counter](#ontime-counter)    |
-|1024   |  64|[Device configuration](#device)           |
-|1536   | 128|[Device configuration 2](#device2)           |
-|2048   | 144|CH1 [calibration parameters](#calibration)|
-|2560   | 144|CH2 [calibration parameters](#calibration)|
-|4096   | 232|[Profile](#profile) 0                     |
-|5120   | 232|[Profile](#profile) 1                     |
-|6144   | 232|[Profile](#profile) 2                     |
-|7168   | 232|[Profile](#profile) 3                     |
-|8192   | 232|[Profile](#profile) 4                     |
-|9216   | 232|[Profile](#profile) 5                     |
-|10240  | 232|[Profile](#profile) 6                     |
-|11264  | 232|[Profile](#profile) 7                     |
-|12288  | 232|[Profile](#profile) 8                     |
-|13312  | 232|[Profile](#profile) 9                     |
+|64     |  64|Total ON-time counter (old format)        |
+|128    |  64|CH1 ON-time counter (old format)          |
+|192    |  64|CH2 ON-time counter (old format)          |
+|256    | 256|[ON-time counters](#ontime-counter), 8 slots|
+|1024   | 512|[Device configuration](#device)            |
+|1536   | 512|[Device configuration 2](#device2)        |
+|2048   | 512|CH1 [calibration parameters](#calibration)|
+|2560   | 512|CH2 [calibration parameters](#calibration)|
+|4096   |1024|[Profile](#profile) 0                     |
+|5120   |1024|[Profile](#profile) 1                     |
+|6144   |1024|[Profile](#profile) 2                     |
+|7168   |1024|[Profile](#profile) 3                     |
+|8192   |1024|[Profile](#profile) 4                     |
+|9216   |1024|[Profile](#profile) 5                     |
+|10240  |1024|[Profile](#profile) 6                     |
+|11264  |1024|[Profile](#profile) 7                     |
+|12288  |1024|[Profile](#profile) 8                     |
+|13312  |1024|[Profile](#profile) 9                     |
 |16384  | 610|[Event Queue](#event-queue)               |
 
-## <a name="ontime-counter">ON-time counter</a>
+Configuration blocks are stored in a ring of slots inside their area. Slot size is
+the block size rounded up to the 64 bytes EEPROM page and the number of slots is
+as many as fit into the area (at least 2). Save writes to the slot after the one
+with the newest valid copy (see sequence in [Block header](#block-header)) and load
+reads the newest valid copy, so interrupted write never destroys the block.
+Every slot starts with the 8 bytes [Block header](#block-header).
+
+|Block                                     |Area|Block size|Slot size|Slots|
+|------------------------------------------|----|----------|---------|-----|
+|[Device configuration](#device)           | 512|        64|       64|    8|
+|[Device configuration 2](#device2)        | 512|       128|      128|    4|
+|CH1/CH2 [calibration parameters](#calibration)| 512|   244|      256|    2|
+|[Profile](#profile)                       |1024|       288|      320|    3|
+
+Sizes are for Arduino Due and the simulator. Block and slot sizes are checked
+with static_assert in persist_conf.cpp.
+
+## <a name="ontime-counter">ON-time counters</a>
+
+All counters are stored together in a ring of 8 slots, 32 bytes each. Slot with the newest
+sequence and valid checksum is the newest one. Counters from the old per counter area
+(magic, counter, counter, written twice) are read only if there is no valid slot.
 
 |Offset|Size|Type                     |Description                  |
 |------|----|-------------------------|-----------------------------|
-|0     |4   |int                      |1st magic number             |
-|4     |4   |int                      |1st counter                  |
-|8     |4   |int                      |1st counter (copy)           |
-|12    |4   |int                      |2nd magic number             |
-|16    |4   |int                      |2nd counter                  |
-|20    |4   |int                      |2bd counter (copy)           |
+|0     |4   |int                      |Magic number                 |
+|4     |2   |int                      |Sequence                     |
+|6     |2   |int                      |Not used                     |
+|8     |4   |int                      |Total counter                |
+|12    |4   |int                      |CH1 counter                  |
+|16    |4   |int                      |CH2 counter                  |
+|20    |8   |int                      |Not used                     |
+|28    |4   |int                      |Checksum                     |
 
 ## <a name="device">Device configuration</a>
 
 |Offset|Size|Type                     |Description                  |
 |------|----|-------------------------|-----------------------------|
-|0     |6   |[struct](#block-header)  |[Block header](#block-header)|
+|0     |8   |[struct](#block-header)  |[Block header](#block-header)|
 |8     |8   |string                   |Serial number                |
 |16    |17  |string                   |Calibration password         |
 |36    |4   |[bitarray](#device-flags)|[Device Flags](#device-flags)|
@@ -79,11 +103,11 @@
 |58    |2   |int                      |Touch screen cal. TRX        |
 |60    |2   |int                      |Touch screen cal. TRY        |
 
-## <a name="device">Device configuration 2</a>
+## <a name="device2">Device configuration 2</a>
 
 |Offset|Size|Type                     |Description                  |
 |------|----|-------------------------|-----------------------------|
-|0     |6   |[struct](#block-header)  |[Block header](#block-header)|
+|0     |8   |[struct](#block-header)  |[Block header](#block-header)|
 |8     |17  |string                   |System password              |
 
 #### <a name="device-flags">Device flags</a>
@@ -114,6 +138,10 @@
 |56    |44  |[struct](#cal-points)  |Current [points](#cal-points)|
 |100   |9   |string                 |Date                         |
 |109   |33  |string                 |Remark                       |
+|144   |48  |[struct](#cal-point)[4] |Additional voltage [points](#cal-point), sorted by DAC value|
+|192   |48  |[struct](#cal-point)[4] |Additional current [points](#cal-point), sorted by DAC value|
+|240   |1   |uint8                  |Number of additional voltage points|
+|241   |1   |uint8                  |Number of additional current points|
 
 #### <a name="cal-flags">Calibration flags</a>
 
@@ -144,7 +172,7 @@
 
 |Offset|Size|Type                   |Description                    |
 |------|----|-----------------------|-------------------------------|
-|0     |6   |[struct](#block-header)|[Block header](#block-header)  |
+|0     |8   |[struct](#block-header)|[Block header](#block-header)  |
 |8     |4   |[bitarray](#prof-flags)|[Flags](#prof-flags)           |
 |12    |33  |string                 |Name                           |
 |48    |52  |[struct](#ch-params)   |CH1 [parameters](#ch-params)   |
@@ -214,10 +242,11 @@
 
 ## <a name="block-header">Block header</a>
 
-|Offset|Size|Type|Description|
-|------|----|----|-----------|
-|0     |4   |int |Checksum   |
-|4     |2   |int |Version    |
+|Offset|Size|Type|Description                                   |
+|------|----|----|----------------------------------------------|
+|0     |4   |int |Checksum (CRC32 of the rest of the block)     |
+|4     |2   |int |Version                                       |
+|6     |2   |int |Sequence, incremented on every save of the block|
 
 ## <a name="event-queue">Event queue</a>
 
@@ -244,6 +273,8 @@ namespace eez {
 namespace psu {
 namespace eeprom {
 
+static const uint16_t EEPROM_PAGE_SIZE = 64;
+
 static const uint16_t EEPROM_TEST_ADDRESS = 0;
 static const uint16_t EEPROM_TEST_BUFFER_SIZE = 64;
 
@@ -258,6 +289,9 @@ static const uint8_t WRITE = 2;
 static const uint16_t EEPROM_ONTIME_START_ADDRESS = 64;
 static const uint16_t EEPROM_ONTIME_SIZE = 64;
 
+static const uint16_t EEPROM_ONTIME_RECORD_START_ADDRESS = 256;
+static const uint16_t EEPROM_ONTIME_RECORD_SIZE = 256;
+
 static const uint16_t EEPROM_START_ADDRESS = 1024;
 
 static const uint16_t EEPROM_EVENT_QUEUE_START_ADDRESS = 16384;
@@ -270,6 +304,13 @@ extern TestResult g_testResult;
 void read(uint8_t *buffer, uint16_t buffer_size, uint16_t address);
 bool write(const uint8_t *buffer, uint16_t buffer_size, uint16_t address);
 
+/// Starts write of the data that fits inside one 64 bytes EEPROM page and returns
+/// without waiting for the EEPROM write cycle to finish. Next read or write will wait for it.
+void writeAsync(const uint8_t *buffer, uint16_t buffer_size, uint16_t address);
+
+/// Waits for the write cycle started by writeAsync to finish.
+void wait_write_end();
+
 }
 }
 } // namespace eez::psu::eeprom
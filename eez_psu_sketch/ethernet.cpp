@@ -34,6 +34,7 @@
 #endif
 
 #include "ethernet.h"
+#include "discovery.h"
 
 namespace eez {
 namespace psu {
@@ -126,6 +127,36 @@ scpi_t scpi_context;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#if defined(EEZ_PSU_SIMULATOR) || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+/// DHCP runs from tick, so the instrument is usable while it waits for the lease.
+static bool g_dhcpPending;
+#endif
+
+static void onNotConnected() {
+    g_testResult = psu::TEST_WARNING;
+    DebugTrace("Ethernet not connected!");
+    event_queue::pushEvent(event_queue::EVENT_WARNING_ETHERNET_NOT_CONNECTED);
+}
+
+static void onConnected() {
+    SPI_beginTransaction(ETHERNET_SPI);
+    server.begin();
+    SPI_endTransaction();
+
+    DebugTraceF("Listening on port %d", (int)TCP_PORT);
+
+#ifdef EEZ_PSU_ARDUINO
+#if CONF_DEBUG || CONF_DEBUG_LATEST
+    Serial.print("My IP: "); Serial.println(Ethernet.localIP());
+    Serial.print("Netmask: "); Serial.println(Ethernet.subnetMask());
+    Serial.print("GW IP: "); Serial.println(Ethernet.gatewayIP());
+    Serial.print("DNS IP: "); Serial.println(Ethernet.dnsServerIP());
+#endif
+#endif
+
+    discovery::init();
+}
+
 void init() {
     if (!persist_conf::isEthernetEnabled()) {
         g_testResult = psu::TEST_SKIPPED;
@@ -143,40 +174,35 @@ void init() {
     Ethernet.setDhcpTimeout(ETHERNET_DHCP_TIMEOUT * 1000UL);
 #endif
 
-    SPI.beginTransaction(ETHERNET_SPI);
+    // registers are kept up to date while DHCP runs, so the context must be ready before it
+    scpi::init(scpi_context,
+        scpi_psu_context,
+        &scpi_interface,
+        scpi_input_buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
+        error_queue_data, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
 
-    if (!Ethernet.begin(mac)) {
-        SPI.endTransaction();
+    g_testResult = psu::TEST_OK;
 
-        g_testResult = psu::TEST_WARNING;
-        DebugTrace("Ethernet not connected!");
-        event_queue::pushEvent(event_queue::EVENT_WARNING_ETHERNET_NOT_CONNECTED);
+#if defined(EEZ_PSU_SIMULATOR) || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+    SPI.beginTransaction(ETHERNET_SPI);
+    g_dhcpPending = Ethernet.beginAsync(mac) ? true : false;
+    SPI.endTransaction();
 
-        return;
+    if (!g_dhcpPending) {
+        onNotConnected();
     }
-
-    server.begin();
-
+#else
+    // UIPEthernet has no background DHCP
+    SPI.beginTransaction(ETHERNET_SPI);
+    bool connected = Ethernet.begin(mac) ? true : false;
     SPI.endTransaction();
 
-    g_testResult = psu::TEST_OK;
-
-    DebugTraceF("Listening on port %d", (int)TCP_PORT);
-
-#ifdef EEZ_PSU_ARDUINO
-#if CONF_DEBUG || CONF_DEBUG_LATEST
-    Serial.print("My IP: "); Serial.println(Ethernet.localIP());
-    Serial.print("Netmask: "); Serial.println(Ethernet.subnetMask());
-    Serial.print("GW IP: "); Serial.println(Ethernet.gatewayIP());
-    Serial.print("DNS IP: "); Serial.println(Ethernet.dnsServerIP());
-#endif
+    if (connected) {
+        onConnected();
+    } else {
+        onNotConnected();
+    }
 #endif
-
-    scpi::init(scpi_context,
-        scpi_psu_context,
-        &scpi_interface,
-        scpi_input_buffer, SCPI_PARSER_INPUT_BUFFER_LENGTH,
-        error_queue_data, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
 }
 
 bool test() {
@@ -188,6 +214,24 @@ bool test() {
 }
 
 void tick(uint32_t tick_usec) {
+#if defined(EEZ_PSU_SIMULATOR) || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12
+    if (g_dhcpPending) {
+        SPI_beginTransaction(ETHERNET_SPI);
+        int result = Ethernet.pollAsync();
+        SPI_endTransaction();
+
+        if (result != DHCP_ASYNC_PENDING) {
+            g_dhcpPending = false;
+            if (result == DHCP_ASYNC_LEASED) {
+                onConnected();
+            } else {
+                onNotConnected();
+            }
+        }
+        return;
+    }
+#endif
+
     if (g_testResult != psu::TEST_OK) {
         return;
     }
@@ -198,6 +242,7 @@ void tick(uint32_t tick_usec) {
         if (!activeClient.connected()) {
             alreadyConnected = false;
             activeClient = EthernetClient();
+            notify_reset(&scpi_context);
             DebugTrace("Ethernet client lost!");
         }
     }
@@ -209,29 +254,45 @@ void tick(uint32_t tick_usec) {
             client.flush();
             activeClient = client;
             alreadyConnected = true;
+            scpi_psu_context.input_overrun = false;
+            notify_reset(&scpi_context);
             DebugTrace("A new ethernet client detected!");
         }
 
-        size_t size;
-        while ((size = client.available()) > 0) {
-            uint8_t* msg = (uint8_t*)malloc(size);
-            size = client.read(msg, size);
+        size_t available;
+        while ((available = client.available()) > 0) {
             if (client == activeClient) {
+                // receive directly into the SCPI input buffer, what doesn't fit
+                // stays in the ethernet controller until parser makes room for it
+                size_t size;
+                char *buffer = getInputBuffer(scpi_context, size);
+                int received = client.read((uint8_t *)buffer, MIN(available, size));
                 SPI_endTransaction();
-                input(scpi_context, (const char *)msg, size);
+                if (received > 0) {
+                    inputCommit(scpi_context, received);
+                }
                 SPI_beginTransaction(ETHERNET_SPI);
             }
             else {
+                uint8_t discard[32];
+                while (client.available() > 0) {
+                    client.read(discard, sizeof(discard));
+                }
                 SPI_endTransaction();
                 ethernet_client_write_str(client, "**ERROR: another client already connected\r\n");
                 SPI_beginTransaction(ETHERNET_SPI);
                 DebugTrace("Another client detected and ignored!");
             }
-            free(msg);
         }
     }
 
     SPI_endTransaction();
+
+    if (alreadyConnected) {
+        notify_tick(&scpi_context, tick_usec);
+    }
+
+    discovery::tick(tick_usec);
 }
 
 uint32_t getIpAddress() {
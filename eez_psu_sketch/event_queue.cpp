@@ -46,6 +46,8 @@ static uint8_t g_pageIndex = 0;
 static Event g_lastErrorEvent;
 static bool g_lastErrorEventChanged;
 
+static uint16_t g_generation;
+
 void readHeader() {
     eeprom::read((uint8_t *)&eventQueue, sizeof(EventQueueHeader), eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS);
 }
@@ -65,6 +67,7 @@ void writeEvent(uint16_t eventIndex, Event *e) {
 void init() {
     readHeader();
     g_lastErrorEventChanged = true;
+    ++g_generation;
 
     if (eventQueue.magicNumber != MAGIC || eventQueue.version != VERSION || eventQueue.head >= MAX_EVENTS || eventQueue.size > MAX_EVENTS) {
         eventQueue.magicNumber = MAGIC;
@@ -97,6 +100,8 @@ void doPushEvent(int16_t eventId) {
         g_lastErrorEventChanged = true;
     }
 
+    ++g_generation;
+
     eventQueue.head = (eventQueue.head + 1) % MAX_EVENTS;
     if (eventQueue.size < MAX_EVENTS) {
         ++eventQueue.size;
@@ -219,10 +224,15 @@ void markAsRead() {
     if (eventQueue.lastErrorEventIndex != NULL_INDEX) {
         eventQueue.lastErrorEventIndex = NULL_INDEX;
         g_lastErrorEventChanged = true;
+        ++g_generation;
         writeHeader();
     }
 }
 
+uint16_t getGeneration() {
+    return g_generation;
+}
+
 int getNumPages() {
     return (getNumEvents() + EVENTS_PER_PAGE - 1) / EVENTS_PER_PAGE;
 }
@@ -161,6 +161,10 @@ void pushEvent(int16_t eventId);
 
 void markAsRead();
 
+/// Generation of the event queue, it is incremented every time
+/// event is pushed or events are marked as read.
+uint16_t getGeneration();
+
 int getNumPages();
 int getActivePageNumEvents();
 void getActivePageEvent(int i, Event *e);
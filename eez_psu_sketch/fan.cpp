@@ -30,12 +30,25 @@ namespace fan {
 
 enum RpmMeasureState {
     RPM_MEASURE_STATE_START,
-    RPM_MEASURE_STATE_MEASURE_T1,
-    RPM_MEASURE_STATE_MEASURE_T2,
+    RPM_MEASURE_STATE_MEASURE,
     RPM_MEASURE_STATE_MEASURED,
     RPM_MEASURE_STATE_FINISHED
 };
 
+/// Fan controller works with fixed point values with 8 fractional bits.
+#define FIXED_SHIFT 8
+#define TO_FIXED(x) ((int32_t)((x) * (1L << FIXED_SHIFT)))
+
+static const int32_t PID_KP = TO_FIXED(FAN_PID_KP);
+static const int32_t PID_KI = TO_FIXED(FAN_PID_KI);
+static const int32_t PID_KD = TO_FIXED(FAN_PID_KD);
+static const int32_t PID_TARGET = TO_FIXED(FAN_PID_TARGET_TEMP);
+static const int32_t PID_OUTPUT_MAX = TO_FIXED(FAN_MAX_PWM);
+
+/// RPM measurement timeout (in us): settle time, then up to one period until the first edge
+/// and FAN_RPM_MEASURE_PERIODS more periods at FAN_MIN_RPM (2 periods per revolution).
+static const uint32_t RPM_MEASURE_TIMEOUT = FAN_RPM_SETTLE_TIME + (FAN_RPM_MEASURE_PERIODS + 1) * (60L * 1000 * 1000 / 2 / FAN_MIN_RPM);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 TestResult g_testResult = psu::TEST_FAILED;
@@ -43,23 +56,28 @@ TestResult g_testResult = psu::TEST_FAILED;
 static uint32_t g_testStartTime;
 
 static int g_fanSpeedPWM = 0;
-static float g_fanSpeed = FAN_MIN_PWM;
 
 static uint32_t g_fanSpeedLastMeasuredTick = 0;
 static uint32_t g_fanSpeedLastAdjustedTick = 0;
 
+static int32_t g_pidIntegral;
+static int32_t g_pidLastTemperature;
+static bool g_pidStarted;
+
 volatile int g_rpm = 0;
 
 static int g_rpmMeasureInterruptNumber;
 static volatile RpmMeasureState g_rpmMeasureState = RPM_MEASURE_STATE_FINISHED;
-static uint32_t g_rpmMeasureT1;
+static uint32_t g_rpmMeasureStartTick;
+static volatile uint8_t g_rpmMeasureEdges;
+static volatile uint32_t g_rpmMeasureT1;
+static volatile uint32_t g_rpmMeasureT2;
 
 ////////////////////////////////////////////////////////////////////////////////
 
 int dt_to_rpm(uint32_t dt) {
-    dt *= 2; // duty cycle is 50%
-    dt *= 2; // 2 impulse per revolution
-    return (int)(60L * 1000 * 1000 / dt);
+    // dt is FAN_RPM_MEASURE_PERIODS periods, 2 periods per revolution
+    return (int)(60L * 1000 * 1000 * FAN_RPM_MEASURE_PERIODS / 2 / dt);
 }
 
 int pwm_to_rpm(int pwm) {
@@ -71,10 +89,13 @@ int pwm_to_rpm(int pwm) {
 void finish_rpm_measure();
 void rpm_measure_interrupt_handler();
 
-void start_rpm_measure() {
-    analogWrite(FAN_PWM, 255);
-    delay(2);
-    attachInterrupt(g_rpmMeasureInterruptNumber, rpm_measure_interrupt_handler, CHANGE);
+void start_rpm_measure(uint32_t tick_usec) {
+    // fan sense is valid only while fan is fully powered
+    if (g_fanSpeedPWM != FAN_MAX_PWM) {
+        analogWrite(FAN_PWM, FAN_MAX_PWM);
+    }
+    g_rpmMeasureStartTick = tick_usec;
+    g_rpmMeasureEdges = 0;
     g_rpmMeasureState = RPM_MEASURE_STATE_START;
 
 #ifdef EEZ_PSU_SIMULATOR
@@ -84,41 +105,106 @@ void start_rpm_measure() {
 }
 
 void rpm_measure_interrupt_handler() {
-    if (g_rpmMeasureState != RPM_MEASURE_STATE_FINISHED && g_rpmMeasureState != RPM_MEASURE_STATE_MEASURED) {
-        // measure length of the square pulse
-        int x = digitalRead(FAN_SENSE);
-        if (g_rpmMeasureState == RPM_MEASURE_STATE_START && x) {
-            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURE_T1;
-        } else if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURE_T1 && !x) {
-            // start is when signal goes from 1 to 0
-            g_rpmMeasureT1 = micros();
-            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURE_T2;
-        } else if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURE_T2 && x) {
-            // stop is when signal goes from 0 to 1
-            uint32_t rpmMeasureT2 = micros();
-            int rpm = dt_to_rpm(rpmMeasureT2 - g_rpmMeasureT1);
-            if (rpm > (int)ceil(FAN_NOMINAL_RPM * 1.05)) {
-                // invalid RPM
-                //// measure again
-                //g_rpmMeasureState = RPM_MEASURE_STATE_MEASURE_T1;
-            } else {
+    if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURE) {
+        // period is measured between falling edges
+        uint32_t t = micros();
+        if (g_rpmMeasureEdges == 0) {
+            g_rpmMeasureT1 = t;
+        } else {
+            g_rpmMeasureT2 = t;
+        }
+
+        if (++g_rpmMeasureEdges > FAN_RPM_MEASURE_PERIODS) {
+            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURED;
+        }
+    }
+}
+
+/// Advances RPM measurement without blocking, returns true when it's finished.
+bool rpm_measure_tick(uint32_t tick_usec) {
+    if (g_rpmMeasureState == RPM_MEASURE_STATE_START) {
+        if (g_fanSpeedPWM == FAN_MAX_PWM || tick_usec - g_rpmMeasureStartTick >= FAN_RPM_SETTLE_TIME) {
+            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURE;
+            attachInterrupt(g_rpmMeasureInterruptNumber, rpm_measure_interrupt_handler, FALLING);
+        }
+    } else if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURED) {
+        if (g_rpmMeasureEdges > FAN_RPM_MEASURE_PERIODS) {
+            int rpm = dt_to_rpm(g_rpmMeasureT2 - g_rpmMeasureT1);
+            if (rpm <= (int)ceil(FAN_NOMINAL_RPM * 1.05)) {
                 g_rpm = rpm;
             }
-            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURED;
         }
+        finish_rpm_measure();
+        return true;
     }
+
+    return g_rpmMeasureState == RPM_MEASURE_STATE_FINISHED;
 }
 
 void finish_rpm_measure() {
     if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURED) {
+        detachInterrupt(g_rpmMeasureInterruptNumber);
         analogWrite(FAN_PWM, g_fanSpeedPWM);
         g_rpmMeasureState = RPM_MEASURE_STATE_FINISHED;
-        detachInterrupt(g_rpmMeasureInterruptNumber);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Power dissipated (in watts) in the output stages of all enabled channels.
+static float get_dissipated_power() {
+    float power = 0;
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel &channel = Channel::get(i);
+        if (channel.isOutputEnabled()) {
+            float channelPower = (channel.getParams().SOA_VIN - channel.u.mon) * channel.i.mon;
+            if (channelPower > 0) {
+                power += channelPower;
+            }
+        }
+    }
+
+    return power;
+}
+
+static void pid_reset() {
+    g_pidIntegral = 0;
+    g_pidStarted = false;
+}
+
+/// Fixed point PID on the temperature with feed-forward, returns fixed point PWM.
+static int32_t pid(int32_t temperature, int32_t feedForward) {
+    int32_t error = temperature - PID_TARGET;
+
+    // derivative is on the temperature, not the error, so there is no kick if target changes
+    int32_t derivative = g_pidStarted ? temperature - g_pidLastTemperature : 0;
+    g_pidLastTemperature = temperature;
+    g_pidStarted = true;
+
+    int32_t output = feedForward + ((PID_KP * error) >> FIXED_SHIFT) + g_pidIntegral + ((PID_KD * derivative) >> FIXED_SHIFT);
+
+    // anti-windup: don't integrate further into saturation
+    if (!(output >= PID_OUTPUT_MAX && error > 0) && !(output <= 0 && error < 0)) {
+        g_pidIntegral += (PID_KI * error) >> FIXED_SHIFT;
+        if (g_pidIntegral > PID_OUTPUT_MAX) {
+            g_pidIntegral = PID_OUTPUT_MAX;
+        } else if (g_pidIntegral < -PID_OUTPUT_MAX) {
+            g_pidIntegral = -PID_OUTPUT_MAX;
+        }
+    }
+
+    if (output < 0) {
+        output = 0;
+    } else if (output > PID_OUTPUT_MAX) {
+        output = PID_OUTPUT_MAX;
+    }
+
+    return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void init() {
     g_rpmMeasureInterruptNumber = digitalPinToInterrupt(FAN_SENSE);
     SPI_usingInterrupt(g_rpmMeasureInterruptNumber);
@@ -144,18 +230,17 @@ bool test() {
         g_fanSpeedPWM = FAN_MAX_PWM;
 #endif
 
-        start_rpm_measure();
+        start_rpm_measure(micros());
 
 #ifdef EEZ_PSU_SIMULATOR
         g_fanSpeedPWM = saved_fan_speed_pwm;
 #endif
 
-        for (int i = 0; i < 25 && g_rpmMeasureState != RPM_MEASURE_STATE_MEASURED; ++i) {
+        while (!rpm_measure_tick(micros()) && micros() - g_rpmMeasureStartTick < RPM_MEASURE_TIMEOUT) {
             delay(1);
         }
 
-        if (g_rpmMeasureState == RPM_MEASURE_STATE_MEASURED) {
-            finish_rpm_measure();
+        if (g_rpmMeasureState == RPM_MEASURE_STATE_FINISHED) {
             g_testResult = psu::TEST_OK;
             DebugTraceF("Fan RPM: %d", g_rpm);
         } else {
@@ -185,22 +270,20 @@ void tick(uint32_t tick_usec) {
         return;
     }
 
-    // adjust fan speed depending on max. channel temperature
+    // adjust fan speed depending on max. channel temperature and dissipated power
     if (tick_usec - g_fanSpeedLastAdjustedTick >= FAN_SPEED_ADJUSTMENT_INTERVAL * 1000L) {
         float max_channel_temperature = temperature::getMaxChannelTemperature();
-        //DebugTraceF("max_channel_temperature: %f", max_channel_temperature);
-
-        float fanSpeedNew = util::remap(max_channel_temperature, FAN_MIN_TEMP, FAN_MIN_PWM, FAN_MAX_TEMP, FAN_MAX_PWM);
-        if (fanSpeedNew >= FAN_MIN_PWM) {
-            if (g_fanSpeed == 0) {
-                g_fanSpeed = FAN_MIN_PWM;
-            } 
-            g_fanSpeed = g_fanSpeed + 0.1f * (fanSpeedNew - g_fanSpeed);
+        float dissipated_power = get_dissipated_power();
+        //DebugTraceF("max_channel_temperature: %f, dissipated_power: %f", max_channel_temperature, dissipated_power);
+
+        int32_t fanSpeed = 0;
+        if (max_channel_temperature >= FAN_MIN_TEMP || dissipated_power * FAN_FF_PWM_PER_WATT >= FAN_MIN_PWM) {
+            fanSpeed = pid(TO_FIXED(max_channel_temperature), TO_FIXED(dissipated_power * FAN_FF_PWM_PER_WATT));
         } else {
-            g_fanSpeed = 0;
+            pid_reset();
         }
 
-        int newFanSpeedPWM = (int)g_fanSpeed;
+        int newFanSpeedPWM = (int)(fanSpeed >> FIXED_SHIFT);
         if (newFanSpeedPWM < FAN_MIN_PWM) {
             newFanSpeedPWM = 0;
         } else if (newFanSpeedPWM > FAN_MAX_PWM) {
@@ -208,16 +291,12 @@ void tick(uint32_t tick_usec) {
         }
 
         if (newFanSpeedPWM != g_fanSpeedPWM) {
-            g_fanSpeedPWM = newFanSpeedPWM;
-
-            if (g_fanSpeedPWM > 0) {
-                //DebugTraceF("fanSpeed PWM: %d", g_fanSpeedPWM);
-    
+            if (g_fanSpeedPWM == 0) {
                 g_fanSpeedLastMeasuredTick = tick_usec;
-            } else {
-                //DebugTrace("fanSpeed OFF");
             }
 
+            g_fanSpeedPWM = newFanSpeedPWM;
+
             if (g_rpmMeasureState == RPM_MEASURE_STATE_FINISHED) {
                 analogWrite(FAN_PWM, g_fanSpeedPWM);
             }
@@ -229,31 +308,30 @@ void tick(uint32_t tick_usec) {
     // measure fan speed
 #if FAN_OPTION_RPM_MEASUREMENT
     if (g_fanSpeedPWM != 0) {
-        if (tick_usec - g_fanSpeedLastMeasuredTick >= FAN_SPEED_MEASURMENT_INTERVAL * 1000L) {
-            g_fanSpeedLastMeasuredTick = tick_usec;
-            start_rpm_measure();
-        } else {
-            RpmMeasureState rpmMeasureState = g_rpmMeasureState;
-            if (rpmMeasureState == RPM_MEASURE_STATE_MEASURED) {
+        if (g_rpmMeasureState == RPM_MEASURE_STATE_FINISHED) {
+            if (tick_usec - g_fanSpeedLastMeasuredTick >= FAN_SPEED_MEASURMENT_INTERVAL * 1000L) {
+                g_fanSpeedLastMeasuredTick = tick_usec;
+                start_rpm_measure(tick_usec);
+            }
+        } else if (!rpm_measure_tick(tick_usec)) {
+            if (tick_usec - g_rpmMeasureStartTick >= RPM_MEASURE_TIMEOUT) {
+                // measure timeout, interrupt measurement
+                g_rpmMeasureState = RPM_MEASURE_STATE_MEASURED;
+                g_rpm = 0;
                 finish_rpm_measure();
-                //DebugTraceF("RPM=%d", g_rpm);
-            } else if (rpmMeasureState != RPM_MEASURE_STATE_FINISHED) {
-                if (tick_usec - g_fanSpeedLastMeasuredTick >= 50 * 1000L) {
-                    // measure timeout, interrupt measurement
-                    g_rpmMeasureState = RPM_MEASURE_STATE_MEASURED;
-                    g_rpm = 0;
-                    finish_rpm_measure();
-
-                    if (g_fanSpeedPWM != 0) {
-                        g_testResult = psu::TEST_FAILED;
-                        psu::generateError(SCPI_ERROR_FAN_TEST_FAILED);
-                        psu::setQuesBits(QUES_FAN, true);
-                        psu::limitMaxCurrent(MAX_CURRENT_LIMIT_CAUSE_FAN);
-                    }
-                }
+
+                g_testResult = psu::TEST_FAILED;
+                psu::generateError(SCPI_ERROR_FAN_TEST_FAILED);
+                psu::setQuesBits(QUES_FAN, true);
+                psu::limitMaxCurrent(MAX_CURRENT_LIMIT_CAUSE_FAN);
             }
         }
     } else {
+        if (g_rpmMeasureState != RPM_MEASURE_STATE_FINISHED) {
+            // fan is switched off during measurement
+            g_rpmMeasureState = RPM_MEASURE_STATE_MEASURED;
+            finish_rpm_measure();
+        }
         g_rpm = 0;
     }
 #else
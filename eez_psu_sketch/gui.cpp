@@ -312,11 +312,6 @@ void showEnteringStandbyPage() {
     }
 }
 
-void showEthernetInit() {
-    doShowPage(PAGE_ID_ETHERNET_INIT);
-    flush();
-}
-
 void pushSelectFromEnumPage(const data::EnumItem *enumDefinition, uint8_t currentValue, uint8_t disabledValue, void (*onSet)(uint8_t)) {
     pushPage(INTERNAL_PAGE_ID_SELECT_FROM_ENUM, new SelectFromEnumPage(enumDefinition, currentValue, disabledValue, onSet));
 }
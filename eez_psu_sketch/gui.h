@@ -34,7 +34,6 @@ void refreshPage();
 void showWelcomePage();
 void showStandbyPage();
 void showEnteringStandbyPage();
-void showEthernetInit();
 
 
 }
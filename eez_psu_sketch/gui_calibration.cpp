@@ -46,6 +46,7 @@ void onStartPasswordOk() {
     g_channel->prot_conf.flags.u_state = 0;
     g_channel->prot_conf.flags.i_state = 0;
     g_channel->prot_conf.flags.p_state = 0;
+    g_channel->onSettingsChanged();
 
     if (g_channel->getFeatures() & CH_FEATURE_RPROG) {
         g_channel->remoteProgrammingEnable(false);
@@ -258,9 +259,10 @@ void stop() {
 
     g_channel->outputEnable(false);
     
-    g_channel->prot_conf.flags.u_state = g_channel->OVP_DEFAULT_STATE;
-    g_channel->prot_conf.flags.i_state = g_channel->OCP_DEFAULT_STATE;
-    g_channel->prot_conf.flags.p_state = g_channel->OPP_DEFAULT_STATE;
+    g_channel->prot_conf.flags.u_state = g_channel->getParams().OVP_DEFAULT_STATE;
+    g_channel->prot_conf.flags.i_state = g_channel->getParams().OCP_DEFAULT_STATE;
+    g_channel->prot_conf.flags.p_state = g_channel->getParams().OPP_DEFAULT_STATE;
+    g_channel->onSettingsChanged();
 }
 
 void toggleEnable() {
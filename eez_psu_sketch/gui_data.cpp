@@ -920,6 +920,62 @@ Value get(const Cursor &cursor, uint8_t id) {
     return Value();
 }
 
+uint32_t getGeneration(const Cursor &cursor, uint8_t id) {
+    if (id == DATA_ID_NONE) {
+        return 1;
+    }
+
+    if (id == DATA_ID_CHANNELS_VIEW_MODE || id == DATA_ID_SYS_PASSWORD_IS_SET) {
+        return ((uint32_t)persist_conf::getGeneration() << 1) | 1;
+    }
+
+    if (id == DATA_ID_CHANNEL_COUPLING_MODE ||
+        id == DATA_ID_CHANNEL_IS_COUPLED ||
+        id == DATA_ID_CHANNEL_IS_TRACKED ||
+        id == DATA_ID_CHANNEL_IS_COUPLED_OR_TRACKED) {
+        return ((uint32_t)channel_dispatcher::getGeneration() << 1) | 1;
+    }
+
+    if (id == DATA_ID_EVENT_QUEUE_LAST_EVENT_TYPE) {
+        return ((uint32_t)event_queue::getGeneration() << 1) | 1;
+    }
+
+    if (id == DATA_ID_CHANNEL_STATUS ||
+        id == DATA_ID_CHANNEL_OUTPUT_STATE ||
+        id == DATA_ID_CHANNEL_U_SET ||
+        id == DATA_ID_CHANNEL_U_EDIT ||
+        id == DATA_ID_CHANNEL_U_LIMIT ||
+        id == DATA_ID_CHANNEL_I_SET ||
+        id == DATA_ID_CHANNEL_I_EDIT ||
+        id == DATA_ID_CHANNEL_I_LIMIT ||
+        id == DATA_ID_LRIP ||
+        id == DATA_ID_CHANNEL_RPROG_STATUS ||
+        id == DATA_ID_OVP ||
+        id == DATA_ID_OCP ||
+        id == DATA_ID_OPP ||
+        id == DATA_ID_CHANNEL_LABEL ||
+        id == DATA_ID_CHANNEL_SHORT_LABEL) {
+        int channelIndex = getCurrentChannelIndex(cursor);
+        if (channelIndex >= CH_NUM || !Channel::get(channelIndex).isOk()) {
+            return 0;
+        }
+
+        if ((id == DATA_ID_CHANNEL_U_EDIT || id == DATA_ID_CHANNEL_I_EDIT) && g_focusCursor == cursor && g_focusDataId == id) {
+            return 0;
+        }
+
+        // in coupled and tracked mode settings of one channel are shown by the other
+        uint32_t generation = channel_dispatcher::getGeneration();
+        for (int i = 0; i < CH_NUM; ++i) {
+            generation += Channel::get(i).getSettingsGeneration();
+        }
+
+        return (generation << 8) | (channelIndex << 1) | 1;
+    }
+
+    return 0;
+}
+
 bool set(const Cursor &cursor, uint8_t id, Value value, int16_t *error) {
     if (id == DATA_ID_CHANNEL_U_SET || id == DATA_ID_CHANNEL_U_EDIT) {
         if (!util::between(value.getFloat(), channel_dispatcher::getUMin(Channel::get(cursor.i)), channel_dispatcher::getUMax(Channel::get(cursor.i)), CHANNEL_VALUE_PRECISION)) {
@@ -987,7 +1043,7 @@ int getNumHistoryValues(uint8_t id) {
 }
 
 int getCurrentHistoryValuePosition(const Cursor &cursor, uint8_t id) {
-    return Channel::get(cursor.i).getCurrentHistoryValuePosition();
+    return Channel::get(cursor.i).trend.getSamplePosition();
 }
 
 Value getHistoryValue(const Cursor &cursor, uint8_t id, int position) {
@@ -213,6 +213,11 @@ ValueType getUnit(const Cursor &cursor, uint8_t id);
 void getList(const Cursor &cursor, uint8_t id, const Value **labels, int &count);
 
 Value get(const Cursor &cursor, uint8_t id);
+
+/// Returns generation of the data, i.e. number which is changed every time the data
+/// is changed, or 0 if generation of the data is not tracked.
+uint32_t getGeneration(const Cursor &cursor, uint8_t id);
+
 bool set(const Cursor &cursor, uint8_t id, Value value, int16_t *error);
 
 int getNumHistoryValues(uint8_t id);
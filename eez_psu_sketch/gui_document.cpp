@@ -7825,7 +7825,7 @@ const uint8_t styles[1235] PROGMEM = {
 #if DISPLAY_ORIENTATION == DISPLAY_ORIENTATION_PORTRAIT
 // DOCUMENT DEFINITION
 const uint8_t document[11162] PROGMEM = {
-    0x07, 0x06, 0x00, 0x43, 0x1B, 0x00, 0x03, 0xC5, 0x03, 0x01, 0xEF, 0x03, 0x03, 0xFD, 0x03, 0x0F,
+    0x07, 0x06, 0x00, 0x42, 0x29, 0x00, 0x03, 0xC5, 0x03, 0x01, 0xEF, 0x03, 0x03, 0xFD, 0x03, 0x0F,
     0x27, 0x04, 0x0D, 0xF9, 0x04, 0x0F, 0xAF, 0x05, 0x0D, 0x81, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0xF0, 0x00, 0x40, 0x01, 0x15, 0x37, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0xF0, 0x00, 0x40, 0x01, 0x15, 0x3D, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x00,
@@ -8527,7 +8527,7 @@ const uint8_t document[11162] PROGMEM = {
 #elif DISPLAY_ORIENTATION == DISPLAY_ORIENTATION_LANDSCAPE
 // DOCUMENT DEFINITION
 const uint8_t document[40039] PROGMEM = {
-    0x07, 0x06, 0x00, 0x43, 0x1B, 0x00, 0x03, 0xC5, 0x03, 0x01, 0xEF, 0x03, 0x03, 0xFD, 0x03, 0x0F,
+    0x07, 0x06, 0x00, 0x42, 0x29, 0x00, 0x03, 0xC5, 0x03, 0x01, 0xEF, 0x03, 0x03, 0xFD, 0x03, 0x0F,
     0x27, 0x04, 0x0D, 0xF9, 0x04, 0x0F, 0xAF, 0x05, 0x0D, 0x81, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00,
     0x00, 0x00, 0x40, 0x01, 0xF0, 0x00, 0x15, 0x37, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
     0x40, 0x01, 0xF0, 0x00, 0x15, 0x3D, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x01,
@@ -342,7 +342,6 @@ enum StylesEnum {
 };
 
 enum PagesEnum {
-    PAGE_ID_ETHERNET_INIT,
     PAGE_ID_SCREEN_CALIBRATION_INTRO,
     PAGE_ID_SCREEN_CALIBRATION_YES_NO,
     PAGE_ID_SCREEN_CALIBRATION_YES_NO_CANCEL,
@@ -236,9 +236,9 @@ ChSettingsOvpProtectionPage::ChSettingsOvpProtectionPage() {
 	defLevel = channel_dispatcher::getUMax(*g_channel);
 
 	origDelay = delay = data::Value(g_channel->prot_conf.u_delay, data::VALUE_TYPE_FLOAT_SECOND);
-	minDelay = g_channel->OVP_MIN_DELAY;
-	maxDelay = g_channel->OVP_MAX_DELAY;
-	defaultDelay = g_channel->OVP_DEFAULT_DELAY;
+	minDelay = g_channel->getParams().OVP_MIN_DELAY;
+	maxDelay = g_channel->getParams().OVP_MAX_DELAY;
+	defaultDelay = g_channel->getParams().OVP_DEFAULT_DELAY;
 }
 
 void ChSettingsOvpProtectionPage::onSetParamsOk() {
@@ -268,9 +268,9 @@ ChSettingsOcpProtectionPage::ChSettingsOcpProtectionPage() {
 	origLevel = level = 0;
 
 	origDelay = delay = data::Value(g_channel->prot_conf.i_delay, data::VALUE_TYPE_FLOAT_SECOND);
-	minDelay = g_channel->OCP_MIN_DELAY;
-	maxDelay = g_channel->OCP_MAX_DELAY;
-	defaultDelay = g_channel->OCP_DEFAULT_DELAY;
+	minDelay = g_channel->getParams().OCP_MIN_DELAY;
+	maxDelay = g_channel->getParams().OCP_MAX_DELAY;
+	defaultDelay = g_channel->getParams().OCP_DEFAULT_DELAY;
 }
 
 void ChSettingsOcpProtectionPage::onSetParamsOk() {
@@ -303,9 +303,9 @@ ChSettingsOppProtectionPage::ChSettingsOppProtectionPage() {
 	defLevel = channel_dispatcher::getOppDefaultLevel(*g_channel);
 
 	origDelay = delay = data::Value(g_channel->prot_conf.p_delay, data::VALUE_TYPE_FLOAT_SECOND);
-	minDelay = g_channel->OPP_MIN_DELAY;
-	maxDelay = g_channel->OPP_MAX_DELAY;
-	defaultDelay = g_channel->OPP_DEFAULT_DELAY;
+	minDelay = g_channel->getParams().OPP_MIN_DELAY;
+	maxDelay = g_channel->getParams().OPP_MAX_DELAY;
+	defaultDelay = g_channel->getParams().OPP_DEFAULT_DELAY;
 }
 
 void ChSettingsOppProtectionPage::onSetParamsOk() {
@@ -28,13 +28,16 @@
 
 #ifdef EEZ_PSU_SIMULATOR
 #include "front_panel/control.h"
+#include "front_panel/headless.h"
 #endif
 
-#define CONF_GUI_ENUM_WIDGETS_STACK_SIZE 5
 #define CONF_GUI_BLINK_TIME 400000UL // 400ms
 #define CONF_GUI_YT_GRAPH_BLANK_PIXELS_AFTER_CURSOR 10
 
-#define CONF_MAX_STATE_SIZE 2048
+#define CONF_GUI_DRAW_LIST_SIZE 128 // max. number of draw list entries per page, with selected options
+#define CONF_GUI_STATE_BUFFER_SLOTS 80 // max. number of widget states per page
+
+#define WIDGET_STATE_SLOT_SIZE ((MAX(sizeof(BarGraphWidgetState), MAX(sizeof(YTGraphWidgetState), sizeof(ListGraphWidgetState))) + 3) & ~3)
 
 namespace eez {
 namespace psu {
@@ -47,7 +50,7 @@ static WidgetCursor g_selectedWidget;
 static bool g_isBlinkTime;
 static bool g_wasBlinkTime;
 
-static uint8_t g_stateBuffer[2][CONF_MAX_STATE_SIZE];
+static uint8_t g_stateBuffer[2][CONF_GUI_STATE_BUFFER_SLOTS * WIDGET_STATE_SLOT_SIZE];
 WidgetState *g_previousState;
 WidgetState *g_currentState;
 
@@ -333,7 +336,7 @@ void drawBitmap(uint8_t bitmapIndex, int x, int y, int w, int h, const Style *st
         lcd::lcd.setBackColor(style->background_color);
         lcd::lcd.setColor(style->color);
     }
-    lcd::lcd.drawBitmap(x_offset, y_offset, width, height, (bitmapdatatype)bitmap.pixels, 1);
+    lcd::lcd.drawBitmap(x_offset, y_offset, width, height, bitmap.pixels);
 }
 
 void drawRectangle(int x, int y, int w, int h, const Style *style, bool inverse) {
@@ -364,7 +367,6 @@ void drawDisplayDataWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(DisplayDataWidget, display_data_widget, widget);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->flags.focused = isFocusWidget(widgetCursor);
     widgetCursor.currentState->flags.blinking = data::isBlinking(widgetCursor.cursor, widget->data) && g_isBlinkTime;
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, 
@@ -391,7 +393,6 @@ void drawDisplayDataWidget(const WidgetCursor &widgetCursor) {
 void drawTextWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->data = widget->data ? data::get(widgetCursor.cursor, widget->data) : 0;
 
     bool refresh = !widgetCursor.previousState ||
@@ -423,7 +424,6 @@ void drawTextWidget(const WidgetCursor &widgetCursor) {
 void drawMultilineTextWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->data = widget->data ? data::get(widgetCursor.cursor, widget->data) : 0;
 
     bool refresh = !widgetCursor.previousState ||
@@ -614,7 +614,6 @@ void drawScale(const Widget *widget, const ScaleWidget *scale_widget, const Styl
 void drawScaleWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
 
     bool refresh = !widgetCursor.previousState ||
@@ -711,7 +710,6 @@ void drawButtonWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(ButtonWidget, button_widget, widget);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->flags.enabled = data::get(widgetCursor.cursor, button_widget->enabled).getInt();
     widgetCursor.currentState->data = widget->data ? data::get(widgetCursor.cursor, widget->data) : 0;
 
@@ -745,7 +743,6 @@ void drawButtonWidget(const WidgetCursor &widgetCursor) {
 void drawToggleButtonWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->flags.enabled = data::get(widgetCursor.cursor, widget->data).getInt();
 
     bool refresh = !widgetCursor.previousState ||
@@ -762,7 +759,6 @@ void drawToggleButtonWidget(const WidgetCursor &widgetCursor) {
 }
 
 void drawRectangleWidget(const WidgetCursor &widgetCursor) {
-    widgetCursor.currentState->size = sizeof(WidgetState);
 
     bool refresh = !widgetCursor.previousState ||
         widgetCursor.previousState->flags.pressed != widgetCursor.currentState->flags.pressed;
@@ -776,7 +772,6 @@ void drawRectangleWidget(const WidgetCursor &widgetCursor) {
 }
 
 void drawBitmapWidget(const WidgetCursor &widgetCursor) {
-    widgetCursor.currentState->size = sizeof(WidgetState);
 
     bool refresh = !widgetCursor.previousState ||
         widgetCursor.previousState->flags.pressed != widgetCursor.currentState->flags.pressed;
@@ -823,7 +818,6 @@ void drawBarGraphWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(BarGraphWidget, barGraphWidget, widget);
 
-    widgetCursor.currentState->size = sizeof(BarGraphWidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
     ((BarGraphWidgetState *)widgetCursor.currentState)->line1Data = data::get(widgetCursor.cursor, barGraphWidget->line1Data);
     ((BarGraphWidgetState *)widgetCursor.currentState)->line2Data = data::get(widgetCursor.cursor, barGraphWidget->line2Data);
@@ -1089,6 +1083,23 @@ void drawBarGraphWidget(const WidgetCursor &widgetCursor) {
     }
 }
 
+/// Y coordinates of the history values of both graph lines,
+/// calculated once when value enters the graph.
+struct YTGraphCache {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    float min1;
+    float max1;
+    float min2;
+    float max2;
+    int16_t y1[CHANNEL_HISTORY_SIZE];
+    int16_t y2[CHANNEL_HISTORY_SIZE];
+};
+
+static YTGraphCache g_ytGraphCache[CH_NUM];
+
 int getYValue(
     const WidgetCursor &widgetCursor, const Widget *widget,
     uint8_t data, float min, float max,
@@ -1112,6 +1123,8 @@ void drawYTGraph(
     uint16_t color, uint16_t backgroundColor
     ) 
 {
+    YTGraphCache &cache = g_ytGraphCache[widgetCursor.cursor.i];
+
     for (int position = startPosition; position < endPosition; ++position) {
         if (position < graphWidth) {
             int x = widgetCursor.x + xGraphOffset + position;
@@ -1119,11 +1132,12 @@ void drawYTGraph(
             lcd::lcd.setColor(color);
             lcd::lcd.drawVLine(x, widgetCursor.y, widget->h - 1);
 
-            int y1 = getYValue(widgetCursor, widget, data1, min1, max1, position);
-            int y1Prev = getYValue(widgetCursor, widget, data1, min1, max1, position == 0 ? position : position - 1);
+            // previous position is always drawn (and cached) before this one
+            int y1 = cache.y1[position] = getYValue(widgetCursor, widget, data1, min1, max1, position);
+            int y1Prev = position == 0 ? y1 : cache.y1[position - 1];
 
-            int y2 = getYValue(widgetCursor, widget, data2, min2, max2, position);
-            int y2Prev = getYValue(widgetCursor, widget, data2, min2, max2, position == 0 ? position : position - 1);
+            int y2 = cache.y2[position] = getYValue(widgetCursor, widget, data2, min2, max2, position);
+            int y2Prev = position == 0 ? y2 : cache.y2[position - 1];
 
             if (abs(y1Prev - y1) <= 1 && abs(y2Prev - y2) <= 1) {
                 if (y1 == y2) {
@@ -1170,7 +1184,6 @@ void drawYTGraphWidget(const WidgetCursor &widgetCursor) {
     DECL_STYLE(y1Style, ytGraphWidget->y1Style);
     DECL_STYLE(y2Style, ytGraphWidget->y2Style);
 
-    widgetCursor.currentState->size = sizeof(YTGraphWidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
     ((YTGraphWidgetState *)widgetCursor.currentState)->y2Data = data::get(widgetCursor.cursor, ytGraphWidget->y2Data);
 
@@ -1223,6 +1236,22 @@ void drawYTGraphWidget(const WidgetCursor &widgetCursor) {
     float min2 = data::getMin(widgetCursor.cursor, ytGraphWidget->y2Data).getFloat();
     float max2 = data::getLimit(widgetCursor.cursor, ytGraphWidget->y2Data).getFloat();
 
+    // cached Y coordinates are valid only for the same graph geometry and range
+    YTGraphCache &cache = g_ytGraphCache[widgetCursor.cursor.i];
+    if (cache.x != widgetCursor.x || cache.y != widgetCursor.y || cache.w != widget->w || cache.h != widget->h ||
+        cache.min1 != min1 || cache.max1 != max1 || cache.min2 != min2 || cache.max2 != max2) 
+    {
+        cache.x = widgetCursor.x;
+        cache.y = widgetCursor.y;
+        cache.w = widget->w;
+        cache.h = widget->h;
+        cache.min1 = min1;
+        cache.max1 = max1;
+        cache.min2 = min2;
+        cache.max2 = max2;
+        refresh = true;
+    }
+
     int startPosition;
     int endPosition;
     if (refresh) {
@@ -1290,7 +1319,6 @@ void drawUpDownWidget(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
     DECL_WIDGET_SPECIFIC(UpDownWidget, upDownWidget, widget);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
 
     bool refresh = !widgetCursor.previousState ||
@@ -1357,7 +1385,6 @@ void drawListGraphWidget(const WidgetCursor &widgetCursor) {
     DECL_STYLE(y2Style, listGraphWidget->y2Style);
     DECL_STYLE(cursorStyle, listGraphWidget->cursorStyle);
 
-    widgetCursor.currentState->size = sizeof(ListGraphWidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
     ((ListGraphWidgetState *)widgetCursor.currentState)->cursorData = data::get(widgetCursor.cursor, listGraphWidget->cursorData);
 
@@ -1550,6 +1577,44 @@ void onTouchListGraph(const WidgetCursor &widgetCursor, int xTouch, int yTouch)
     }
 }
 
+/// Returns generation of all the data widget depends on,
+/// or 0 if widget must be evaluated in every frame.
+static uint32_t getWidgetGeneration(const WidgetCursor &widgetCursor) {
+    DECL_WIDGET(widget, widgetCursor.widgetOffset);
+
+    if (widget->type == WIDGET_TYPE_TEXT ||
+        widget->type == WIDGET_TYPE_MULTILINE_TEXT ||
+        widget->type == WIDGET_TYPE_RECTANGLE ||
+        widget->type == WIDGET_TYPE_BITMAP ||
+        widget->type == WIDGET_TYPE_TOGGLE_BUTTON ||
+        widget->type == WIDGET_TYPE_BUTTON_GROUP) {
+        return data::getGeneration(widgetCursor.cursor, widget->data);
+    }
+
+    if (widget->type == WIDGET_TYPE_BUTTON) {
+        DECL_WIDGET_SPECIFIC(ButtonWidget, button_widget, widget);
+        uint32_t dataGeneration = data::getGeneration(widgetCursor.cursor, widget->data);
+        uint32_t enabledGeneration = data::getGeneration(widgetCursor.cursor, button_widget->enabled);
+        if (!dataGeneration || !enabledGeneration) {
+            return 0;
+        }
+        return dataGeneration + enabledGeneration;
+    }
+
+    if (widget->type == WIDGET_TYPE_DISPLAY_DATA) {
+        // focus and blinking are not covered by the generation
+        if (isFocusWidget(widgetCursor) || (data::isBlinking(widgetCursor.cursor, widget->data) && g_isBlinkTime)) {
+            return 0;
+        }
+        if (widgetCursor.previousState && (widgetCursor.previousState->flags.focused || widgetCursor.previousState->flags.blinking)) {
+            return 0;
+        }
+        return data::getGeneration(widgetCursor.cursor, widget->data);
+    }
+
+    return 0;
+}
+
 void drawWidget(const WidgetCursor &widgetCursor_) {
     WidgetCursor widgetCursor = widgetCursor_;
 
@@ -1569,6 +1634,17 @@ void drawWidget(const WidgetCursor &widgetCursor_) {
 
     widgetCursor.currentState->flags.pressed = g_selectedWidget == widgetCursor;
 
+    uint32_t generation = g_widgetRefresh ? 0 : getWidgetGeneration(widgetCursor);
+    if (generation &&
+        widgetCursor.previousState &&
+        widgetCursor.previousState->generation == generation &&
+        widgetCursor.previousState->flags.pressed == widgetCursor.currentState->flags.pressed) {
+        // nothing is changed since the last frame, skip evaluation and just carry over the state
+        memcpy(widgetCursor.currentState, widgetCursor.previousState, widgetCursor.previousState->size);
+        return;
+    }
+    widgetCursor.currentState->generation = generation;
+
     if (widget->type == WIDGET_TYPE_DISPLAY_DATA) {
         drawDisplayDataWidget(widgetCursor);
     } else if (widget->type == WIDGET_TYPE_TEXT) {
@@ -1625,38 +1701,84 @@ WidgetState *next(WidgetState *p) {
     return p ? (WidgetState *)(((uint8_t *)p) + p->size) : 0;
 }
 
-void enumWidget(OBJ_OFFSET widgetOffset, int x, int y, data::Cursor &cursor, WidgetState *previousState, WidgetState *currentState, EnumWidgetsCallback callback);
+WidgetState *nextSlot(WidgetState *p) {
+    return p ? (WidgetState *)(((uint8_t *)p) + WIDGET_STATE_SLOT_SIZE) : 0;
+}
 
-void enumContainer(List widgets, int x, int y, data::Cursor &cursor, WidgetState *previousState, WidgetState *currentState, EnumWidgetsCallback callback) {
-    WidgetState *savedCurrentState = currentState;
+////////////////////////////////////////////////////////////////////////////////
+// Draw list
+//
+// Widget tree of the active page is flattened, when page is activated, into
+// the array of entries with precalculated coordinates. Containers and custom
+// widgets are completely dissolved, so drawing a frame is a linear scan of
+// this array. LIST widget keeps its item subtree in the entries following
+// the LIST entry, up to the entry at index "end", with coordinates relative
+// to the item position. SELECT entry is followed by one
+// DRAW_LIST_SELECT_OPTION entry per option. The option subtree is compiled,
+// with coordinates relative to the SELECT widget, at the end of the draw
+// list when the option is selected for the first time, and the option entry
+// keeps its range [first, end).
+//
+// If the draw list fills up, compiled options are dropped at the start of the
+// next frame and compiled again as they get selected. Draw list is sized to
+// fit every page with the largest combination of selected options (83 entries
+// on the main page), with some room left for the options selected before.
+//
+// Every widget uses one fixed size slot in the state buffer. LIST and SELECT
+// widgets use one additional slot (header) where the size of the subtree
+// state is stored, so the states of the previous and the current frame can
+// stay aligned when list count or selected option changes.
+
+#define DRAW_LIST_SELECT_OPTION 255
+
+struct DrawListEntry {
+    OBJ_OFFSET widgetOffset;
+    int16_t x;
+    int16_t y;
+    uint16_t first; // first entry of the option subtree, 0 if not compiled
+    uint16_t end;
+    uint8_t type;
+};
+
+static DrawListEntry g_drawList[CONF_GUI_DRAW_LIST_SIZE];
+static uint16_t g_drawListSize;
+static uint16_t g_drawListPageSize; // option subtrees are compiled after the page entries
+static uint16_t g_drawListFrameStartSize;
+static bool g_drawListOverflow;
+static int g_drawListPageId = -1;
+static bool g_drawListHasState;
+
+int compileWidget(OBJ_OFFSET widgetOffset, int x, int y, bool addEntries);
+
+int addDrawListEntry(OBJ_OFFSET widgetOffset, int x, int y, uint8_t type) {
+    if (g_drawListSize == CONF_GUI_DRAW_LIST_SIZE) {
+        g_drawListOverflow = true;
+        return -1;
+    }
 
-    WidgetState *endOfContainerInPreviousState;
-    if (previousState) endOfContainerInPreviousState = next(previousState);
+    DrawListEntry &entry = g_drawList[g_drawListSize];
+    entry.widgetOffset = widgetOffset;
+    entry.x = x;
+    entry.y = y;
+    entry.type = type;
+    entry.first = 0;
+    entry.end = g_drawListSize + 1;
 
-    // move to the first child widget state
-    if (previousState) ++previousState;
-    if (currentState) ++currentState;
+    return g_drawListSize++;
+}
 
+int compileContainer(List widgets, int x, int y, bool addEntries) {
+    int numSlots = 0;
     for (int index = 0; index < widgets.count; ++index) {
-        OBJ_OFFSET childWidgetOffset = getListItemOffset(widgets, index, sizeof(Widget));
-        enumWidget(childWidgetOffset, x, y, cursor, previousState, currentState, callback);
-
-        if (previousState) {
-            previousState = next(previousState);
-            if (previousState >= endOfContainerInPreviousState) previousState = 0;
-        }
-        
-        currentState = next(currentState);
-    }
-
-    if (currentState) {
-        savedCurrentState->size = ((uint8_t *)currentState) - ((uint8_t *)savedCurrentState);
+        numSlots += compileWidget(getListItemOffset(widgets, index, sizeof(Widget)), x, y, addEntries);
     }
+    return numSlots;
 }
 
-void enumWidget(OBJ_OFFSET widgetOffset, int x, int y, data::Cursor &cursor, WidgetState *previousState, WidgetState *currentState, EnumWidgetsCallback callback) {
-    psu::criticalTick();
-
+/// Adds widget to the draw list.
+/// @param addEntries If false, only the number of state slots is calculated
+/// @returns max. number of state slots used by the widget
+int compileWidget(OBJ_OFFSET widgetOffset, int x, int y, bool addEntries) {
     DECL_WIDGET(widget, widgetOffset);
 
     x += widget->x;
@@ -1664,102 +1786,268 @@ void enumWidget(OBJ_OFFSET widgetOffset, int x, int y, data::Cursor &cursor, Wid
 
     if (widget->type == WIDGET_TYPE_CONTAINER) {
         DECL_WIDGET_SPECIFIC(ContainerWidget, container, widget);
-        enumContainer(container->widgets, x, y, cursor, previousState, currentState, callback);
+        return compileContainer(container->widgets, x, y, addEntries);
     }
-    else if (widget->type == WIDGET_TYPE_CUSTOM) {
+    
+    if (widget->type == WIDGET_TYPE_CUSTOM) {
         DECL_WIDGET_SPECIFIC(CustomWidgetSpecific, customWidgetSpecific, widget);
         DECL_CUSTOM_WIDGET(customWidget, customWidgetSpecific->customWidget);
-        enumContainer(customWidget->widgets, x, y, cursor, previousState, currentState, callback);
+        return compileContainer(customWidget->widgets, x, y, addEntries);
+    }
+    
+    int entryIndex = -1;
+    if (addEntries) {
+        entryIndex = addDrawListEntry(widgetOffset, x, y, widget->type);
+        if (entryIndex == -1) {
+            return 0;
+        }
     }
-    else if (widget->type == WIDGET_TYPE_LIST) {
-        WidgetState *savedCurrentState = currentState;
 
-        WidgetState *endOfContainerInPreviousState;
-        if (previousState) endOfContainerInPreviousState = next(previousState);
+    if (widget->type == WIDGET_TYPE_LIST) {
+        DECL_WIDGET_SPECIFIC(ListWidget, listWidget, widget);
+        DECL_WIDGET(childWidget, listWidget->item_widget);
 
-        // move to the first child widget state
-        if (previousState) ++previousState;
-        if (currentState) ++currentState;
+        // items are enumerated until list widget is filled
+        int maxItems;
+        if (listWidget->listType == LIST_TYPE_VERTICAL) {
+            maxItems = childWidget->h > 0 ? (widget->h + childWidget->h - 1) / childWidget->h : 1;
+        } else {
+            maxItems = childWidget->w > 0 ? (widget->w + childWidget->w - 1) / childWidget->w : 1;
+        }
 
-        int xOffset = 0;
-        int yOffset = 0;
-        for (int index = 0; index < data::count(widget->data); ++index) {
-            data::select(cursor, widget->data, index);
+        // coordinates inside item are relative to the item position
+        int itemNumSlots = compileWidget(listWidget->item_widget, 0, 0, addEntries);
 
-            DECL_WIDGET_SPECIFIC(ListWidget, listWidget, widget);
-            OBJ_OFFSET childWidgetOffset = listWidget->item_widget;
+        if (entryIndex != -1) {
+            g_drawList[entryIndex].end = g_drawListSize;
+        }
 
-            if (listWidget->listType == LIST_TYPE_VERTICAL) {
-                DECL_WIDGET(childWidget, childWidgetOffset);
-                if (yOffset < widget->h) {
-                    enumWidget(childWidgetOffset, x + xOffset, y + yOffset, cursor, previousState, currentState, callback);
-                    yOffset += childWidget->h;
-                } else {
-                    // TODO: add vertical scroll
-                    break;
-                }
-            } else {
-                DECL_WIDGET(childWidget, childWidgetOffset);
-                if (xOffset < widget->w) {
-                    enumWidget(childWidgetOffset, x + xOffset, y + yOffset, cursor, previousState, currentState, callback);
-                    xOffset += childWidget->w;
-                } else {
-                    // TODO: add horizontal scroll
-                    break;
-                }
-            }
+        return 1 + maxItems * itemNumSlots;
+    }
+    
+    if (widget->type == WIDGET_TYPE_SELECT) {
+        DECL_WIDGET_SPECIFIC(SelectWidget, selectWidget, widget);
+
+        int maxOptionNumSlots = 0;
+        for (int index = 0; index < selectWidget->widgets.count; ++index) {
+            OBJ_OFFSET optionWidgetOffset = getListItemOffset(selectWidget->widgets, index, sizeof(Widget));
 
-            if (previousState) {
-                previousState = next(previousState);
-                if (previousState >= endOfContainerInPreviousState) previousState = 0;
+            // option subtree is compiled when option is selected
+            if (entryIndex != -1) {
+                addDrawListEntry(optionWidgetOffset, 0, 0, DRAW_LIST_SELECT_OPTION);
             }
-        
-            currentState = next(currentState);
+
+            maxOptionNumSlots = MAX(maxOptionNumSlots, compileWidget(optionWidgetOffset, 0, 0, false));
         }
 
-        if (currentState) {
-            savedCurrentState->size = ((uint8_t *)currentState) - ((uint8_t *)savedCurrentState);
+        if (entryIndex != -1) {
+            g_drawList[entryIndex].end = g_drawListSize;
         }
 
-        data::select(cursor, widget->data, -1);
+        return 1 + maxOptionNumSlots;
     }
-    else if (widget->type == WIDGET_TYPE_SELECT) {
-        data::Value indexValue = data::get(cursor, widget->data);
+    
+    return 1;
+}
+
+void compileDrawList(int pageIndex) {
+    g_drawListPageId = pageIndex;
+    g_drawListSize = 0;
+    g_drawListOverflow = false;
 
-        if (currentState) {
-            currentState->data = indexValue;
+    // one slot is used for the page header
+    int numSlots = 1 + compileWidget(getPageOffset(pageIndex), 0, 0, true);
+
+    g_drawListPageSize = g_drawListSize;
+    if (g_drawListOverflow) {
+        DebugTraceF("Page %d doesn't fit into draw list", pageIndex);
+    }
+
+    // If page doesn't fit into the state buffer it will be drawn without state,
+    // i.e. all the widgets are redrawn on every frame.
+    g_drawListHasState = numSlots <= CONF_GUI_STATE_BUFFER_SLOTS;
+    if (!g_drawListHasState) {
+        DebugTraceF("Page %d requires %d state slots", pageIndex, numSlots);
+    }
+}
+
+/// Drops all compiled options if the draw list filled up in the previous frame.
+void resetSelectOptions() {
+    if (g_drawListOverflow && g_drawListSize > g_drawListPageSize) {
+        g_drawListSize = g_drawListPageSize;
+        g_drawListOverflow = false;
+
+        for (int i = 0; i < g_drawListPageSize; ++i) {
+            if (g_drawList[i].type == DRAW_LIST_SELECT_OPTION) {
+                g_drawList[i].first = 0;
+            }
         }
+    }
+}
 
-        if (previousState && previousState->data != currentState->data) {
-            previousState = 0;
+/// Compiles option subtree at the end of the draw list, if it is not already compiled.
+/// @returns false if it doesn't fit, option is then skipped until the next frame
+bool compileSelectOption(DrawListEntry &option) {
+    if (option.first == 0) {
+        uint16_t first = g_drawListSize;
+        compileWidget(option.widgetOffset, 0, 0, true);
+        if (g_drawListOverflow) {
+            if (g_drawListFrameStartSize == g_drawListPageSize) {
+                DebugTraceF("Page %d selected options don't fit into draw list", g_drawListPageId);
+            }
+            return false;
         }
+        option.first = first;
+        option.end = g_drawListSize;
+    }
+    return true;
+}
+
+void enumDrawList(int first, int last, int xOffset, int yOffset, data::Cursor &cursor, WidgetState *&previousState, WidgetState *previousStateEnd, WidgetState *&currentState, EnumWidgetsCallback callback);
 
-        WidgetState *savedCurrentState = currentState;
+void enumList(const Widget *widget, int first, int last, int x, int y, data::Cursor &cursor, WidgetState *&previousState, WidgetState *&currentState, EnumWidgetsCallback callback) {
+    DECL_WIDGET_SPECIFIC(ListWidget, listWidget, widget);
+    DECL_WIDGET(childWidget, listWidget->item_widget);
+
+    WidgetState *savedPreviousState = previousState;
+    WidgetState *savedCurrentState = currentState;
 
-        // move to the selected widget state
-        if (previousState) ++previousState;
-        if (currentState) ++currentState;
+    WidgetState *endOfContainerInPreviousState = next(previousState);
+
+    // move to the first child widget state
+    previousState = nextSlot(previousState);
+    currentState = nextSlot(currentState);
+
+    int xItemOffset = 0;
+    int yItemOffset = 0;
+    for (int index = 0; index < data::count(widget->data); ++index) {
+        if (listWidget->listType == LIST_TYPE_VERTICAL) {
+            if (yItemOffset >= widget->h) {
+                // TODO: add vertical scroll
+                break;
+            }
+        } else {
+            if (xItemOffset >= widget->w) {
+                // TODO: add horizontal scroll
+                break;
+            }
+        }
 
-        int index = indexValue.getInt();
         data::select(cursor, widget->data, index);
-        DECL_WIDGET_SPECIFIC(ContainerWidget, containerWidget, widget);
-        OBJ_OFFSET selectedWidgetOffset = getListItemOffset(containerWidget->widgets, index, sizeof(Widget));
 
-        enumWidget(selectedWidgetOffset, x, y, cursor, previousState, currentState, callback);
+        enumDrawList(first, last, x + xItemOffset, y + yItemOffset, cursor, previousState, endOfContainerInPreviousState, currentState, callback);
 
-        if (currentState) {
-            savedCurrentState->size = sizeof(WidgetState) + currentState->size;
+        if (listWidget->listType == LIST_TYPE_VERTICAL) {
+            yItemOffset += childWidget->h;
+        } else {
+            xItemOffset += childWidget->w;
         }
     }
-    else {
-        callback(WidgetCursor(widgetOffset, x, y, cursor, previousState, currentState));
+
+    data::select(cursor, widget->data, -1);
+
+    if (currentState) {
+        savedCurrentState->size = ((uint8_t *)currentState) - ((uint8_t *)savedCurrentState);
+    }
+
+    previousState = next(savedPreviousState);
+}
+
+void enumSelect(const Widget *widget, int first, int last, int x, int y, data::Cursor &cursor, WidgetState *&previousState, WidgetState *&currentState, EnumWidgetsCallback callback) {
+    data::Value indexValue = data::get(cursor, widget->data);
+
+    WidgetState *savedPreviousState = previousState;
+    WidgetState *savedCurrentState = currentState;
+
+    if (currentState) {
+        currentState->data = indexValue;
+    }
+
+    if (previousState && previousState->data != indexValue) {
+        previousState = 0;
+    }
+
+    WidgetState *endOfContainerInPreviousState = next(previousState);
+
+    // move to the selected widget state
+    previousState = nextSlot(previousState);
+    currentState = nextSlot(currentState);
+
+    int index = indexValue.getInt();
+    data::select(cursor, widget->data, index);
+
+    // [first, last) are the option entries
+    if (index >= 0 && first + index < last) {
+        DrawListEntry &option = g_drawList[first + index];
+        if (compileSelectOption(option)) {
+            enumDrawList(option.first, option.end, x, y, cursor, previousState, endOfContainerInPreviousState, currentState, callback);
+        }
+    }
+
+    if (currentState) {
+        savedCurrentState->size = ((uint8_t *)currentState) - ((uint8_t *)savedCurrentState);
+    }
+
+    previousState = next(savedPreviousState);
+}
+
+void enumDrawList(int first, int last, int xOffset, int yOffset, data::Cursor &cursor, WidgetState *&previousState, WidgetState *previousStateEnd, WidgetState *&currentState, EnumWidgetsCallback callback) {
+    for (int i = first; i < last; i = g_drawList[i].end) {
+        psu::criticalTick();
+
+        const DrawListEntry &entry = g_drawList[i];
+        int x = xOffset + entry.x;
+        int y = yOffset + entry.y;
+
+        if (entry.type == WIDGET_TYPE_LIST) {
+            DECL_WIDGET(widget, entry.widgetOffset);
+            enumList(widget, i + 1, entry.end, x, y, cursor, previousState, currentState, callback);
+        } else if (entry.type == WIDGET_TYPE_SELECT) {
+            DECL_WIDGET(widget, entry.widgetOffset);
+            enumSelect(widget, i + 1, entry.end, x, y, cursor, previousState, currentState, callback);
+        } else {
+            if (currentState) {
+                currentState->size = WIDGET_STATE_SLOT_SIZE;
+            }
+
+            callback(WidgetCursor(entry.widgetOffset, x, y, cursor, previousState, currentState));
+
+            currentState = nextSlot(currentState);
+            previousState = nextSlot(previousState);
+        }
+
+        if (previousState >= previousStateEnd) {
+            previousState = 0;
+        }
     }
 }
 
 void enumWidgets(int pageIndex, WidgetState *previousState, WidgetState *currentState, EnumWidgetsCallback callback) {
+    if (pageIndex != g_drawListPageId) {
+        compileDrawList(pageIndex);
+    } else {
+        resetSelectOptions();
+    }
+    g_drawListFrameStartSize = g_drawListSize;
+
+    if (!g_drawListHasState) {
+        previousState = 0;
+        currentState = 0;
+    }
+
+    // first slot is the page header
+    WidgetState *savedCurrentState = currentState;
+    WidgetState *previousStateEnd = next(previousState);
+    previousState = nextSlot(previousState);
+    currentState = nextSlot(currentState);
+
     data::Cursor cursor;
     cursor.reset();
-    enumWidget(getPageOffset(pageIndex), 0, 0, cursor, previousState, currentState, callback);
+    enumDrawList(0, g_drawListPageSize, 0, 0, cursor, previousState, previousStateEnd, currentState, callback);
+
+    if (currentState) {
+        savedCurrentState->size = ((uint8_t *)currentState) - ((uint8_t *)savedCurrentState);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1806,6 +2094,10 @@ void drawActivePage(bool refresh) {
 static bool g_refreshPageOnNextTick;
 
 void drawTick() {
+#ifdef EEZ_PSU_SIMULATOR
+    simulator::front_panel::beginFrame();
+#endif
+
     if (isActivePageInternal()) {
         ((InternalPage *)getActivePage())->drawTick();
     } else {
@@ -1817,6 +2109,10 @@ void drawTick() {
             drawActivePage(false);
         }
     }
+
+#ifdef EEZ_PSU_SIMULATOR
+    simulator::front_panel::endFrame(getActivePageId());
+#endif
 }
 
 
@@ -118,6 +118,8 @@ struct WidgetState {
     uint16_t size;
     WidgetStateFlags flags;
     data::Value data;
+    /// Generation of the widget data, 0 if not tracked.
+    uint32_t generation;
 };
 
 struct ContainerWidget {
@@ -91,7 +91,6 @@ void drawButtons(const Widget* widget, int x, int y, const Style *style, int sel
 void draw(const WidgetCursor &widgetCursor) {
     DECL_WIDGET(widget, widgetCursor.widgetOffset);
 
-    widgetCursor.currentState->size = sizeof(WidgetState);
     widgetCursor.currentState->data = data::get(widgetCursor.cursor, widget->data);
 
     bool refresh = !widgetCursor.previousState ||
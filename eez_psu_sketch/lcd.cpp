@@ -126,273 +126,52 @@ int8_t EEZ_UTFT::drawGlyph(int x1, int y1, int clip_x1, int clip_y1, int clip_x2
     if (width > 0 && height > 0) {
 	    clear_bit(P_CS, B_CS);
 
-#if DISPLAY_TYPE == ITDB32S_V2 && !defined(EEZ_PSU_SIMULATOR)
-#if DISPLAY_ORIENTATION != DISPLAY_ORIENTATION_LANDSCAPE
-#error "Only LANDSCAPE display orientation is supported on ITDB32S_V2"
-#endif
-        // optimized drawing for ITDB32S_V2
-
-#define PIXEL_ON { \
-    sbi(P_RS, B_RS); \
-    REG_PIOA_CODR=0x0000C080; \
-    REG_PIOC_CODR=0x0000003E; \
-    REG_PIOD_CODR=0x0000064F; \
-    REG_PIOA_SODR=REG_PIOA_SODR_FG; \
-    FG_TEST ? REG_PIOB_SODR = 0x4000000 : REG_PIOB_CODR = 0x4000000; \
-    REG_PIOC_SODR=REG_PIOC_SODR_FG; \
-    REG_PIOD_SODR=REG_PIOD_SODR_FG; \
-    pulse_low(P_WR, B_WR); \
-}
-
-#define PIXEL_OFF { \
-    sbi(P_RS, B_RS); \
-    REG_PIOA_CODR=0x0000C080; \
-    REG_PIOC_CODR=0x0000003E; \
-    REG_PIOD_CODR=0x0000064F; \
-    REG_PIOA_SODR=REG_PIOA_SODR_BG; \
-    BG_TEST ? REG_PIOB_SODR = 0x4000000 : REG_PIOB_CODR = 0x4000000; \
-    REG_PIOC_SODR=REG_PIOC_SODR_BG; \
-    REG_PIOD_SODR=REG_PIOD_SODR_BG; \
-    pulse_low(P_WR, B_WR); \
-}
-
-#define SET_PIXEL(C) \
-    if (C) { \
-        if (LAST_PIXEL == 1) { \
-            pulse_low(P_WR, B_WR); \
-        } else { \
-            PIXEL_ON; \
-            LAST_PIXEL = 1; \
-        } \
-    } else { \
-        if (LAST_PIXEL == 0) { \
-            pulse_low(P_WR, B_WR); \
-        } else { \
-            PIXEL_OFF; \
-            LAST_PIXEL = 0; \
-        } \
-    }
-
-        uint32_t REG_PIOA_SODR_FG =((fch & 0x06)<<13) | ((fcl & 0x40)<<1);
-        uint32_t REG_PIOC_SODR_FG =((fcl & 0x01)<<5) | ((fcl & 0x02)<<3) | ((fcl & 0x04)<<1) | ((fcl & 0x08)>>1) | ((fcl & 0x10)>>3);
-        uint32_t REG_PIOD_SODR_FG =((fch & 0x78)>>3) | ((fch & 0x80)>>1) | ((fcl & 0x20)<<5) | ((fcl & 0x80)<<2);
-        int FG_TEST = fch & 0x01;
+        word fc = (fch << 8) | fcl;
+        word bc = (bch << 8) | bcl;
 
-        uint32_t REG_PIOA_SODR_BG =((bch & 0x06)<<13) | ((bcl & 0x40)<<1);
-        uint32_t REG_PIOC_SODR_BG =((bcl & 0x01)<<5) | ((bcl & 0x02)<<3) | ((bcl & 0x04)<<1) | ((bcl & 0x08)>>1) | ((bcl & 0x10)>>3);
-        uint32_t REG_PIOD_SODR_BG =((bch & 0x78)>>3) | ((bch & 0x80)>>1) | ((bcl & 0x20)<<5) | ((bcl & 0x80)<<2);
-        int BG_TEST = bch & 0x01;
+        // index of the first visible glyph column
+        int iStartPixel = iStartByte * 8 + iStartCol;
 
         int numPixels = 0;
 
-        int iEndByte = iStartByte + (width + 7) / 8;
-        int x1_glyph = x_glyph;
-        int x2_glyph = x_glyph + width - 1;
-
-        if (paintEnabled) {
-            while (height--) {
-                setXY(x1_glyph, y_glyph, x2_glyph, y_glyph);
-                ++y_glyph;
-
-                const uint8_t *p_data = glyph.data + offset + iEndByte;
-                for (int iByte = iEndByte; iByte >= iStartByte; --iByte, numPixels += 8) {
-                    if (numPixels % 40 == 0) {
-                        psu::criticalTick();
-                    }
-
-                    uint8_t data = *p_data--;
-
-                    int LAST_PIXEL = -1;
-
-                    int iPixel = (iByte << 3) + 7;
-                    if (iPixel - 7 >= iStartCol && iPixel < width) {
-                        SET_PIXEL(data & (0x80 >> 7));
-                        SET_PIXEL(data & (0x80 >> 6));
-                        SET_PIXEL(data & (0x80 >> 5));
-                        SET_PIXEL(data & (0x80 >> 4));
-                        SET_PIXEL(data & (0x80 >> 3));
-                        SET_PIXEL(data & (0x80 >> 2));
-                        SET_PIXEL(data & (0x80 >> 1));
-                        SET_PIXEL(data & (0x80 >> 0));
-                    } else {
-                                    if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 7));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 6));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 5));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 4));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 3));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 2));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 1));
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) SET_PIXEL(data & (0x80 >> 0));
-                    }
-                }
+        if (orient == PORTRAIT) {
+            setXY(x_glyph, y_glyph, x_glyph + width - 1, y_glyph + height - 1);
+        }
 
-                offset += widthInBytes;
+        for (int iRow = 0; iRow < height; ++iRow, offset += widthInBytes) {
+            if (orient != PORTRAIT) {
+                setXY(x_glyph, y_glyph + iRow, x_glyph + width - 1, y_glyph + iRow);
             }
-        } else {
-            while (height--) {
-                setXY(x1_glyph, y_glyph, x2_glyph, y_glyph);
-                ++y_glyph;
-
-                const uint8_t *p_data = glyph.data + offset + iEndByte;
-                for (int iByte = iEndByte; iByte >= iStartByte; --iByte, numPixels += 8) {
-                    if (numPixels % 120 == 0) {
-                        psu::criticalTick();
-                    }
 
-                    uint8_t data = *p_data--;
-
-                    int LAST_PIXEL = -1;
-
-                    int iPixel = (iByte << 3) + 7;
-                    if (iPixel - 7 >= iStartCol && iPixel < width) {
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                        PIXEL_OFF;
-                    } else {
-                                    if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
-                        --iPixel; if (iPixel >= iStartCol && iPixel < width) PIXEL_OFF;
+            if (!paintEnabled) {
+                writeRun(bc, width);
+            } else {
+                // in landscape orientation controller expects pixels from right to left
+                int iPixel = orient == PORTRAIT ? iStartPixel : iStartPixel + width - 1;
+                int step = orient == PORTRAIT ? 1 : -1;
+
+                bool runIsOn = false;
+                int runLength = 0;
+                for (int i = 0; i < width; ++i, iPixel += step) {
+                    uint8_t data = arduino_util::prog_read_byte(glyph.data + offset + (iPixel >> 3));
+                    bool isOn = (data & (0x80 >> (iPixel & 7))) != 0;
+                    if (isOn != runIsOn && runLength > 0) {
+                        writeRun(runIsOn ? fc : bc, runLength);
+                        runLength = 0;
                     }
+                    runIsOn = isOn;
+                    ++runLength;
                 }
+                writeRun(runIsOn ? fc : bc, runLength);
+            }
 
-                offset += widthInBytes;
+            numPixels += width;
+            if (numPixels >= 120) {
+                psu::criticalTick();
+                numPixels = 0;
             }
         }
-#else
-        word fc = (fch << 8) | fcl;
-        word bc = (bch << 8) | bcl;
 
-	    if (orient == PORTRAIT) {
-            int numPixels = 0;
-
-            setXY(x_glyph, y_glyph, x_glyph + width - 1, y_glyph + height - 1);
-		    for (int iRow = 0; iRow < height; ++iRow, offset += widthInBytes) {
-			    for (int iByte = iStartByte, iCol = iStartCol; iByte < widthInBytes; ++iByte, numPixels += 8) {
-                    if (numPixels % 120 == 0) {
-                        psu::criticalTick();
-                    }
-
-                    uint8_t data = arduino_util::prog_read_byte(glyph.data + offset + iByte);
-                    if (paintEnabled) {
-                        if (iCol + 8 <= width) {
-                            setPixel(data & 0x80 ? fc : bc);
-                            setPixel(data & 0x40 ? fc : bc);
-                            setPixel(data & 0x20 ? fc : bc);
-                            setPixel(data & 0x10 ? fc : bc);
-                            setPixel(data & 0x08 ? fc : bc);
-                            setPixel(data & 0x04 ? fc : bc);
-                            setPixel(data & 0x02 ? fc : bc);
-                            setPixel(data & 0x01 ? fc : bc);
-                            iCol += 8;
-                        } else {
-                            if (iCol++ >= width) break; setPixel(data & 0x80 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x40 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x20 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x10 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x08 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x04 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x02 ? fc : bc);
-                            if (iCol++ >= width) break; setPixel(data & 0x01 ? fc : bc);
-                        }
-                    } else {
-                        if (iCol + 8 <= width) {
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            iCol += 8;
-                        } else {
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                            if (iCol++ >= width) break; setPixel(bc);
-                        }
-                    }
-			    }
-		    }
-	    }
-	    else {
-            int numPixels = 0;
-
-		    for (int iRow = 0; iRow < height; ++iRow) {
-			    setXY(x_glyph, y_glyph + iRow, x_glyph + width - 1, y_glyph + iRow);
-			    for (int iByte = iStartByte + (width + 7) / 8; iByte >= iStartByte; --iByte, numPixels += 8) {
-                    if (numPixels % 120 == 0) {
-                        psu::criticalTick();
-                    }
-
-#if defined(EEZ_PSU_ARDUINO_DUE)
-				    uint8_t data = *(glyph.data + offset + iByte);
-#else
-				    uint8_t data = arduino_util::prog_read_byte(glyph.data + offset + iByte);
-#endif
-
-                    int iPixel = iByte * 8 + 7;
-                    if (iPixel - 7 >= iStartCol && iPixel < width) {
-                        if (paintEnabled) {
-                            setPixel((data & (0x80 >> 7)) ? fc : bc);
-                            setPixel((data & (0x80 >> 6)) ? fc : bc);
-                            setPixel((data & (0x80 >> 5)) ? fc : bc);
-                            setPixel((data & (0x80 >> 4)) ? fc : bc);
-                            setPixel((data & (0x80 >> 3)) ? fc : bc);
-                            setPixel((data & (0x80 >> 2)) ? fc : bc);
-                            setPixel((data & (0x80 >> 1)) ? fc : bc);
-                            setPixel((data & (0x80 >> 0)) ? fc : bc);
-                        } else {
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                            setPixel(bc);
-                        }
-                    } else {
-                        if (paintEnabled) {
-					                  if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 7)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 6)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 5)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 4)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 3)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 2)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 1)) ? fc : bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel((data & (0x80 >> 0)) ? fc : bc);
-                        } else {
-                                      if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                            --iPixel; if (iPixel >= iStartCol && iPixel < width) setPixel(bc);
-                        }
-                    }
-                }
-
-			    offset += widthInBytes;
-		    }
-	    }
-#endif
 	    set_bit(P_CS, B_CS);
 	    clrXY();
     }
@@ -416,6 +195,67 @@ void EEZ_UTFT::drawStr(const char *text, int textLength, int x, int y, int clip_
     }
 }
 
+void EEZ_UTFT::writeRun(word color, int count) {
+#if !defined(EEZ_PSU_SIMULATOR)
+    byte ch = color >> 8;
+    byte cl = color & 0xFF;
+    if (display_transfer_mode == 16 || (display_transfer_mode == 8 && ch == cl)) {
+        // first pixel sets RS and data lines, for the rest only WR is strobed
+        LCD_Write_DATA(ch, cl);
+        int numStrobes = display_transfer_mode == 16 ? count - 1 : 2 * (count - 1);
+        while (numStrobes-- > 0) {
+            pulse_low(P_WR, B_WR);
+        }
+        return;
+    }
+#endif
+
+    while (count--) {
+        setPixel(color);
+    }
+}
+
+void EEZ_UTFT::drawBitmap(int x, int y, int sx, int sy, const uint8_t *data PROGMEM) {
+	clear_bit(P_CS, B_CS);
+
+    if (orient == PORTRAIT) {
+        setXY(x, y, x + sx - 1, y + sy - 1);
+    }
+
+    for (int iRow = 0; iRow < sy; ++iRow) {
+        psu::criticalTick();
+
+        // in landscape orientation controller expects pixels from right to left
+        int iPixel;
+        int step;
+        if (orient == PORTRAIT) {
+            iPixel = iRow * sx;
+            step = 1;
+        } else {
+            setXY(x, y + iRow, x + sx - 1, y + iRow);
+            iPixel = iRow * sx + sx - 1;
+            step = -1;
+        }
+
+        word runColor = 0;
+        int runLength = 0;
+        for (int i = 0; i < sx; ++i, iPixel += step) {
+            // pixels are stored as little endian 16-bit values
+            word color = arduino_util::prog_read_byte(data + 2 * iPixel) | (arduino_util::prog_read_byte(data + 2 * iPixel + 1) << 8);
+            if (color != runColor && runLength > 0) {
+                writeRun(runColor, runLength);
+                runLength = 0;
+            }
+            runColor = color;
+            ++runLength;
+        }
+        writeRun(runColor, runLength);
+    }
+
+	set_bit(P_CS, B_CS);
+	clrXY();
+}
+
 int8_t EEZ_UTFT::measureGlyph(uint8_t encoding) {
     font::Glyph glyph;
 	font.getGlyph(encoding, glyph);
@@ -33,15 +33,21 @@ public:
     void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, font::Font &font, bool fill_background);
     int measureStr(const char *text, int textLength, font::Font &font, int max_width = 0);
 
+    /// Draws bitmap with 16-bit pixels stored in PROGMEM, runs of the same color are written at once.
+    void drawBitmap(int x, int y, int sx, int sy, const uint8_t *data PROGMEM);
+
     //void fillRect();
     //void drawRect();
-    //void drawBitmap();
     //void drawHLine();
     //void drawVLine();
 
 private:
     font::Font font;
 
+    /// Writes count pixels of the same color into the current setXY window.
+    /// On the parallel bus data lines are set only once and then WR is strobed for every pixel.
+    void writeRun(word color, int count);
+
     int8_t drawGlyph(int x1, int y1, int clip_x1, int clip_y1, int clip_x2, int clip_y2, uint8_t encoding, bool fill_background);
     int8_t measureGlyph(uint8_t encoding);
 };
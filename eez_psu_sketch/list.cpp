@@ -46,8 +46,13 @@ static struct {
     int counter;
     int it;
     uint32_t nextPointTime;
+    uint32_t stepCounter;
 } g_execution[CH_NUM];
 
+/// Incremented from the EXT_TRIG interrupt, each channel advances
+/// until its own counter catches up.
+static volatile uint32_t g_stepCounter;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void init() {
@@ -144,6 +149,11 @@ void executionSetCurrent(Channel &channel) {
 void executionStart(Channel &channel) {
     g_execution[channel.index - 1].it = -1;
     g_execution[channel.index - 1].counter = g_channelsLists[channel.index - 1].count;
+    g_execution[channel.index - 1].stepCounter = g_stepCounter;
+}
+
+void step() {
+    ++g_stepCounter;
 }
 
 int maxListsSize(Channel &channel) {
@@ -208,6 +218,8 @@ void tick(uint32_t tick_usec) {
         }
     }
 
+    bool stepped = false;
+
     for (int i = 0; i < CH_NUM; ++i) {
         Channel &channel = Channel::get(i);
         if (g_execution[i].counter >= 0) {
@@ -215,6 +227,11 @@ void tick(uint32_t tick_usec) {
 
             if (g_execution[i].it == -1) {
                 set = true;
+            } else if (trigger::getStepSource() == trigger::STEP_SOURCE_PIN1) {
+                if (g_execution[i].stepCounter != g_stepCounter) {
+                    ++g_execution[i].stepCounter;
+                    set = true;
+                }
             } else {
                 int32_t diff = g_execution[i].nextPointTime - tick_usec;
                 if (diff <= 0) {
@@ -281,9 +298,16 @@ void tick(uint32_t tick_usec) {
 
                 uint32_t dwell = (uint32_t)round(g_channelsLists[i].dwellList[g_execution[i].it % g_channelsLists[i].dwellListSize] * 1000000L);
                 g_execution[i].nextPointTime = tick_usec + dwell;
+
+                stepped = true;
             }
         }
     }
+
+    // one pulse for all channels that stepped in this tick
+    if (stepped) {
+        trigger::outputPulse(trigger::OUTPUT_SOURCE_STEP);
+    }
 }
 
 bool isActive() {
@@ -50,6 +50,10 @@ void executionSetVoltage(Channel &channel);
 void executionSetCurrent(Channel &channel);
 void executionStart(Channel &channel);
 
+/// Advances all executing lists to the next point, used when
+/// the list steps are driven by the EXT_TRIG pin.
+void step();
+
 void tick(uint32_t tick_usec);
 
 bool isActive();
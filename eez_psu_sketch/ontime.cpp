@@ -43,7 +43,6 @@ void counterToString(char *str, size_t count, uint32_t counterTime) {
 Counter::Counter(int type_)
 	: typeAndIsActive(type_)
 	, lastTime(0)
-	, writeInterval(WRITE_ONTIME_INTERVAL * MIN_TO_MS)
 	, fractionTime(0)
 {
 }
@@ -88,10 +87,6 @@ void Counter::tick(uint32_t tick_usec) {
 		lastTime += time;
 		fractionTime -= time * MIN_TO_MS;
 	}
-
-	if (writeInterval.test(tick_usec)) {
-		persist_conf::writeTotalOnTime(getType(), getTotalTime());
-	}
 }
 
 uint32_t Counter::getTotalTime() {
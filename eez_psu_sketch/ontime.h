@@ -54,7 +54,6 @@ private:
 	uint32_t lastTime;
 	uint32_t lastTick;
 	uint32_t fractionTime;
-	Interval writeInterval;
 };
 
 }
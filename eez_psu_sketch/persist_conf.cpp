@@ -47,7 +47,9 @@ enum PersistConfSection {
 
 static const uint16_t DEV_CONF_VERSION = 0x0008L;
 static const uint16_t DEV_CONF2_VERSION = 0x0002L;
-static const uint16_t CH_CAL_CONF_VERSION = 0x0003L;
+static const uint16_t CH_CAL_CONF_VERSION = 0x0004L;
+/// Version 3 of the calibration block is the same as version 4 without additional points.
+static const uint16_t CH_CAL_CONF_VERSION_3 = 0x0003L;
 static const uint16_t PROFILE_VERSION = 0x0007L;
 
 static const uint16_t PERSIST_CONF_DEVICE_ADDRESS = 1024;
@@ -59,13 +61,71 @@ static const uint16_t PERSIST_CONF_CH_CAL_BLOCK_SIZE = 512;
 static const uint16_t PERSIST_CONF_FIRST_PROFILE_ADDRESS = 4096;
 static const uint16_t PERSIST_CONF_PROFILE_BLOCK_SIZE = 1024;
 
+/// Every block is stored in a ring of slots inside its area. Save goes to the slot
+/// after the newest valid one and load picks the newest valid one, so if write is
+/// interrupted (power failure) the previous copy is still there.
+/// Slot size is the block size rounded up to the EEPROM page.
+#define PERSIST_CONF_SLOT_SIZE(block) ((sizeof(block) + eeprom::EEPROM_PAGE_SIZE - 1) / eeprom::EEPROM_PAGE_SIZE * eeprom::EEPROM_PAGE_SIZE)
+
+static const uint16_t PERSIST_CONF_DEVICE_SLOT_SIZE = PERSIST_CONF_SLOT_SIZE(DeviceConfiguration);
+static const int PERSIST_CONF_DEVICE_NUM_SLOTS = (PERSIST_CONF_DEVICE2_ADDRESS - PERSIST_CONF_DEVICE_ADDRESS) / PERSIST_CONF_DEVICE_SLOT_SIZE;
+static_assert(sizeof(DeviceConfiguration) <= PERSIST_CONF_DEVICE_SLOT_SIZE && PERSIST_CONF_DEVICE_NUM_SLOTS >= 2, "Device configuration doesn't fit");
+
+static const uint16_t PERSIST_CONF_DEVICE2_SLOT_SIZE = PERSIST_CONF_SLOT_SIZE(DeviceConfiguration2);
+static const int PERSIST_CONF_DEVICE2_NUM_SLOTS = (PERSIST_CONF_CH_CAL_ADDRESS - PERSIST_CONF_DEVICE2_ADDRESS) / PERSIST_CONF_DEVICE2_SLOT_SIZE;
+static_assert(sizeof(DeviceConfiguration2) <= PERSIST_CONF_DEVICE2_SLOT_SIZE && PERSIST_CONF_DEVICE2_NUM_SLOTS >= 2, "Device configuration 2 doesn't fit");
+
+static const uint16_t PERSIST_CONF_CH_CAL_SLOT_SIZE = PERSIST_CONF_SLOT_SIZE(Channel::CalibrationConfiguration);
+static const int PERSIST_CONF_CH_CAL_NUM_SLOTS = PERSIST_CONF_CH_CAL_BLOCK_SIZE / PERSIST_CONF_CH_CAL_SLOT_SIZE;
+static_assert(sizeof(Channel::CalibrationConfiguration) <= PERSIST_CONF_CH_CAL_SLOT_SIZE && PERSIST_CONF_CH_CAL_NUM_SLOTS >= 2, "Calibration configuration doesn't fit");
+static_assert(PERSIST_CONF_CH_CAL_ADDRESS + CH_MAX * PERSIST_CONF_CH_CAL_BLOCK_SIZE <= PERSIST_CONF_FIRST_PROFILE_ADDRESS, "Calibration configurations overlap profiles");
+
+static const uint16_t PERSIST_CONF_PROFILE_SLOT_SIZE = PERSIST_CONF_SLOT_SIZE(profile::Parameters);
+static const int PERSIST_CONF_PROFILE_NUM_SLOTS = PERSIST_CONF_PROFILE_BLOCK_SIZE / PERSIST_CONF_PROFILE_SLOT_SIZE;
+static_assert(sizeof(profile::Parameters) <= PERSIST_CONF_PROFILE_SLOT_SIZE && PERSIST_CONF_PROFILE_NUM_SLOTS >= 2, "Profile doesn't fit");
+static_assert(PERSIST_CONF_FIRST_PROFILE_ADDRESS + NUM_PROFILE_LOCATIONS * PERSIST_CONF_PROFILE_BLOCK_SIZE <= eeprom::EEPROM_EVENT_QUEUE_START_ADDRESS, "Profiles overlap event queue");
+
+/// Newest slot of every ring is found once and then kept up to date by save,
+/// so load and save don't have to read and check all the slots every time.
+/// Version is a part of the key because the old version of the calibration
+/// block is stored in the same ring.
+struct NewestSlot {
+    uint16_t address;
+    uint16_t version;
+    uint16_t sequence;
+    int8_t slot;
+};
+
+static const int NEWEST_SLOT_CACHE_SIZE = 2 + 2 * CH_MAX + NUM_PROFILE_LOCATIONS;
+static NewestSlot g_newestSlotCache[NEWEST_SLOT_CACHE_SIZE];
+static int g_newestSlotCacheSize;
+
 static const uint32_t ONTIME_MAGIC = 0xA7F31B3CL;
 
+/// All on-time counters are stored together in one record, written in a ring of slots.
+static const int ONTIME_RECORD_NUM_COUNTERS = 5;
+static const int ONTIME_RECORD_NUM_SLOTS = 8;
+
+struct OnTimeRecord {
+    uint32_t magic;
+    uint16_t sequence;
+    uint16_t reserved;
+    uint32_t counters[ONTIME_RECORD_NUM_COUNTERS];
+    uint32_t checksum;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DeviceConfiguration devConf;
 DeviceConfiguration2 devConf2;
 
+static uint16_t g_generation;
+
+static OnTimeRecord g_onTimeRecord;
+static int g_onTimeRecordSlot = -1;
+static bool g_onTimeRecordLoaded;
+static Interval g_onTimeWriteInterval(WRITE_ONTIME_INTERVAL * 60 * 1000L);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 uint32_t calc_checksum(const BlockHeader *block, uint16_t size) {
@@ -76,11 +136,127 @@ bool check_block(const BlockHeader *block, uint16_t size, uint16_t version) {
     return block->checksum == calc_checksum(block, size) && block->version == version;
 }
 
-bool save(BlockHeader *block, uint16_t size, uint16_t address, uint16_t version) {
+/// Checks the block stored in EEPROM without reading it all into RAM.
+static bool check_slot(uint16_t address, uint16_t size, uint16_t version, BlockHeader &header) {
+    eeprom::read((uint8_t *)&header, sizeof(BlockHeader), address);
+    if (header.version != version) {
+        return false;
+    }
+
+    uint32_t checksum = util::crc32Update(0, ((const uint8_t *)&header) + sizeof(uint32_t), sizeof(BlockHeader) - sizeof(uint32_t));
+
+    uint8_t buffer[32];
+    for (uint16_t i = sizeof(BlockHeader); i < size; i += sizeof(buffer)) {
+        uint16_t n = size - i;
+        if (n > sizeof(buffer)) {
+            n = sizeof(buffer);
+        }
+        eeprom::read(buffer, n, address + i);
+        checksum = util::crc32Update(checksum, buffer, n);
+    }
+
+    return header.checksum == checksum;
+}
+
+static NewestSlot *find_cached_newest_slot(uint16_t address, uint16_t version) {
+    for (int i = 0; i < g_newestSlotCacheSize; ++i) {
+        if (g_newestSlotCache[i].address == address && g_newestSlotCache[i].version == version) {
+            return &g_newestSlotCache[i];
+        }
+    }
+    return 0;
+}
+
+static void set_cached_newest_slot(uint16_t address, uint16_t version, int slot, uint16_t sequence) {
+    NewestSlot *newestSlot = find_cached_newest_slot(address, version);
+    if (!newestSlot) {
+        if (g_newestSlotCacheSize == NEWEST_SLOT_CACHE_SIZE) {
+            return;
+        }
+        newestSlot = &g_newestSlotCache[g_newestSlotCacheSize++];
+        newestSlot->address = address;
+        newestSlot->version = version;
+    }
+    newestSlot->slot = slot;
+    newestSlot->sequence = sequence;
+}
+
+static void invalidate_cached_newest_slot(uint16_t address, uint16_t version) {
+    NewestSlot *newestSlot = find_cached_newest_slot(address, version);
+    if (newestSlot) {
+        *newestSlot = g_newestSlotCache[--g_newestSlotCacheSize];
+    }
+}
+
+/// Returns the slot with the newest valid copy of the block or -1 if there is none.
+static int find_newest_slot(uint16_t address, uint16_t size, uint16_t slotSize, int numSlots, uint16_t version, uint16_t &sequence) {
+    NewestSlot *cached = find_cached_newest_slot(address, version);
+    if (cached) {
+        sequence = cached->sequence;
+        return cached->slot;
+    }
+
+    int newestSlot = -1;
+
+    for (int slot = 0; slot < numSlots; ++slot) {
+        BlockHeader header;
+        if (check_slot(address + slot * slotSize, size, version, header)) {
+            if (newestSlot == -1 || (int16_t)(header.sequence - sequence) > 0) {
+                newestSlot = slot;
+                sequence = header.sequence;
+            }
+        }
+    }
+
+    set_cached_newest_slot(address, version, newestSlot, sequence);
+
+    return newestSlot;
+}
+
+bool load(BlockHeader *block, uint16_t size, uint16_t address, uint16_t slotSize, int numSlots, uint16_t version) {
+    if (eeprom::g_testResult == psu::TEST_OK) {
+        // second attempt is with the slots scanned again, if cached slot is not valid anymore
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            uint16_t sequence;
+            int slot = find_newest_slot(address, size, slotSize, numSlots, version, sequence);
+            if (slot == -1) {
+                break;
+            }
+
+            eeprom::read((uint8_t *)block, size, address + slot * slotSize);
+            if (check_block(block, size, version)) {
+                return true;
+            }
+
+            invalidate_cached_newest_slot(address, version);
+        }
+    }
+    return false;
+}
+
+bool save(BlockHeader *block, uint16_t size, uint16_t address, uint16_t slotSize, int numSlots, uint16_t version) {
+    ++g_generation;
+
     if (eeprom::g_testResult == psu::TEST_OK) {
+        uint16_t sequence;
+        int slot = find_newest_slot(address, size, slotSize, numSlots, version, sequence);
+        if (slot != -1) {
+            slot = (slot + 1) % numSlots;
+            ++sequence;
+        } else {
+            slot = 0;
+            sequence = 0;
+        }
+
         block->version = version;
+        block->sequence = sequence;
         block->checksum = calc_checksum(block, size);
-        return eeprom::write((const uint8_t *)block, size, address);
+        if (!eeprom::write((const uint8_t *)block, size, address + slot * slotSize)) {
+            invalidate_cached_newest_slot(address, version);
+            return false;
+        }
+
+        set_cached_newest_slot(address, version, slot, sequence);
     }
     return true;
 }
@@ -146,15 +322,12 @@ static void initDevice() {
 }
 
 void loadDevice() {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::read((uint8_t *)&devConf, sizeof(DeviceConfiguration), get_address(PERSIST_CONF_BLOCK_DEVICE));
-        if (!check_block((BlockHeader *)&devConf, sizeof(DeviceConfiguration), DEV_CONF_VERSION)) {
-            initDevice();
-        } else {
-			if (devConf.flags.channelsViewMode < 0 || devConf.flags.channelsViewMode >= NUM_CHANNELS_VIEW_MODES) {
-				devConf.flags.channelsViewMode = 0;
-			}
-		}
+    ++g_generation;
+
+    if (load((BlockHeader *)&devConf, sizeof(DeviceConfiguration), get_address(PERSIST_CONF_BLOCK_DEVICE), PERSIST_CONF_DEVICE_SLOT_SIZE, PERSIST_CONF_DEVICE_NUM_SLOTS, DEV_CONF_VERSION)) {
+        if (devConf.flags.channelsViewMode < 0 || devConf.flags.channelsViewMode >= NUM_CHANNELS_VIEW_MODES) {
+            devConf.flags.channelsViewMode = 0;
+        }
     }
     else {
         initDevice();
@@ -162,7 +335,7 @@ void loadDevice() {
 }
 
 bool saveDevice() {
-    return save((BlockHeader *)&devConf, sizeof(DeviceConfiguration), get_address(PERSIST_CONF_BLOCK_DEVICE), DEV_CONF_VERSION);
+    return save((BlockHeader *)&devConf, sizeof(DeviceConfiguration), get_address(PERSIST_CONF_BLOCK_DEVICE), PERSIST_CONF_DEVICE_SLOT_SIZE, PERSIST_CONF_DEVICE_NUM_SLOTS, DEV_CONF_VERSION);
 }
 
 static void initDevice2() {
@@ -174,13 +347,9 @@ static void initDevice2() {
 }
 
 void loadDevice2() {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::read((uint8_t *)&devConf2, sizeof(DeviceConfiguration2), get_address(PERSIST_CONF_BLOCK_DEVICE2));
-        if (!check_block((BlockHeader *)&devConf2, sizeof(DeviceConfiguration2), DEV_CONF2_VERSION)) {
-            initDevice2();
-        }
-    }
-    else {
+    ++g_generation;
+
+    if (!load((BlockHeader *)&devConf2, sizeof(DeviceConfiguration2), get_address(PERSIST_CONF_BLOCK_DEVICE2), PERSIST_CONF_DEVICE2_SLOT_SIZE, PERSIST_CONF_DEVICE2_NUM_SLOTS, DEV_CONF2_VERSION)) {
         initDevice2();
     }
 
@@ -196,7 +365,7 @@ void loadDevice2() {
 }
 
 bool saveDevice2() {
-    return save((BlockHeader *)&devConf2, sizeof(DeviceConfiguration2), get_address(PERSIST_CONF_BLOCK_DEVICE2), DEV_CONF2_VERSION);
+    return save((BlockHeader *)&devConf2, sizeof(DeviceConfiguration2), get_address(PERSIST_CONF_BLOCK_DEVICE2), PERSIST_CONF_DEVICE2_SLOT_SIZE, PERSIST_CONF_DEVICE2_NUM_SLOTS, DEV_CONF2_VERSION);
 }
 
 bool isSystemPasswordValid(const char *new_password, size_t new_password_len, int16_t &err) {
@@ -299,6 +468,20 @@ bool isEthernetEnabled() {
     return devConf.flags.ethernetEnabled ? true : false;
 }
 
+bool setStatusBroadcastPeriod(uint16_t period) {
+    uint16_t currentPeriod = devConf2.statusBroadcastPeriod;
+
+    if (currentPeriod != period) {
+        devConf2.statusBroadcastPeriod = period;
+        if (!saveDevice2()) {
+            devConf2.statusBroadcastPeriod = currentPeriod;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool readSystemDate(uint8_t &year, uint8_t &month, uint8_t &day) {
     if (devConf.flags.date_valid) {
         year = devConf.date_year;
@@ -382,38 +565,43 @@ void toggleChannelsViewMode() {
 }
 
 void loadChannelCalibration(Channel *channel) {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::read((uint8_t *)&channel->cal_conf, sizeof(Channel::CalibrationConfiguration), get_address(PERSIST_CONF_BLOCK_CH_CAL, channel));
-        if (!check_block((BlockHeader *)&channel->cal_conf, sizeof(Channel::CalibrationConfiguration), CH_CAL_CONF_VERSION)) {
+    Channel::CalibrationConfiguration &cal_conf = channel->cal_conf;
+    if (!load((BlockHeader *)&cal_conf, sizeof(Channel::CalibrationConfiguration), get_address(PERSIST_CONF_BLOCK_CH_CAL, channel), PERSIST_CONF_CH_CAL_SLOT_SIZE, PERSIST_CONF_CH_CAL_NUM_SLOTS, CH_CAL_CONF_VERSION)) {
+        if (load((BlockHeader *)&cal_conf, offsetof(Channel::CalibrationConfiguration, u_extra_points), get_address(PERSIST_CONF_BLOCK_CH_CAL, channel), PERSIST_CONF_CH_CAL_SLOT_SIZE, PERSIST_CONF_CH_CAL_NUM_SLOTS, CH_CAL_CONF_VERSION_3)) {
+            memset(cal_conf.u_extra_points, 0, sizeof(cal_conf.u_extra_points));
+            memset(cal_conf.i_extra_points, 0, sizeof(cal_conf.i_extra_points));
+            cal_conf.u_num_extra_points = 0;
+            cal_conf.i_num_extra_points = 0;
+            // mid point was never validated in version 3
+            cal_conf.flags.u_ignore_mid = 1;
+            cal_conf.flags.i_ignore_mid = 1;
+        } else {
             channel->clearCalibrationConf();
         }
     }
-    else {
-        channel->clearCalibrationConf();
-    }
 }
 
 bool saveChannelCalibration(Channel *channel) {
-    return save((BlockHeader *)&channel->cal_conf, sizeof(Channel::CalibrationConfiguration), get_address(PERSIST_CONF_BLOCK_CH_CAL, channel), CH_CAL_CONF_VERSION);
+    return save((BlockHeader *)&channel->cal_conf, sizeof(Channel::CalibrationConfiguration), get_address(PERSIST_CONF_BLOCK_CH_CAL, channel), PERSIST_CONF_CH_CAL_SLOT_SIZE, PERSIST_CONF_CH_CAL_NUM_SLOTS, CH_CAL_CONF_VERSION);
 }
 
 bool loadProfile(int location, profile::Parameters *profile) {
-    if (eeprom::g_testResult == psu::TEST_OK) {
-        eeprom::read((uint8_t *)profile, sizeof(profile::Parameters), get_profile_address(location));
-        return check_block((BlockHeader *)profile, sizeof(profile::Parameters), PROFILE_VERSION);
-    }
-    return false;
+    return load((BlockHeader *)profile, sizeof(profile::Parameters), get_profile_address(location), PERSIST_CONF_PROFILE_SLOT_SIZE, PERSIST_CONF_PROFILE_NUM_SLOTS, PROFILE_VERSION);
 }
 
 bool saveProfile(int location, profile::Parameters *profile) {
-    return save((BlockHeader *)profile, sizeof(profile::Parameters), get_profile_address(location), PROFILE_VERSION);
+    return save((BlockHeader *)profile, sizeof(profile::Parameters), get_profile_address(location), PERSIST_CONF_PROFILE_SLOT_SIZE, PERSIST_CONF_PROFILE_NUM_SLOTS, PROFILE_VERSION);
 }
 
-uint32_t readTotalOnTime(int type) {
+static uint16_t get_ontime_address(int type) {
+    return eeprom::EEPROM_ONTIME_START_ADDRESS + type * eeprom::EEPROM_ONTIME_SIZE;
+}
+
+/// Reads the counter from the released format: magic, counter, counter, magic, counter, counter.
+static uint32_t read_old_total_on_time(int type) {
 	uint32_t buffer[6];
 
-	eeprom::read((uint8_t *)buffer, sizeof(buffer),
-		eeprom::EEPROM_ONTIME_START_ADDRESS + type * eeprom::EEPROM_ONTIME_SIZE);
+	eeprom::read((uint8_t *)buffer, sizeof(buffer), get_ontime_address(type));
 
 	if (buffer[0] == ONTIME_MAGIC && buffer[1] == buffer[2]) {
 		if (buffer[3] == ONTIME_MAGIC && buffer[4] == buffer[5]) {
@@ -431,21 +619,89 @@ uint32_t readTotalOnTime(int type) {
 	return 0;
 }
 
-bool writeTotalOnTime(int type, uint32_t time) {
-	uint32_t buffer[6];
+static uint32_t calc_ontime_record_checksum(const OnTimeRecord &record) {
+    return util::crc32((const uint8_t *)&record, offsetof(OnTimeRecord, checksum));
+}
+
+static void load_ontime_record() {
+    g_onTimeRecordLoaded = true;
+
+    if (eeprom::g_testResult == psu::TEST_OK) {
+        for (int slot = 0; slot < ONTIME_RECORD_NUM_SLOTS; ++slot) {
+            OnTimeRecord record;
+            eeprom::read((uint8_t *)&record, sizeof(OnTimeRecord), eeprom::EEPROM_ONTIME_RECORD_START_ADDRESS + slot * sizeof(OnTimeRecord));
+            if (record.magic == ONTIME_MAGIC && record.checksum == calc_ontime_record_checksum(record)) {
+                if (g_onTimeRecordSlot == -1 || (int16_t)(record.sequence - g_onTimeRecord.sequence) > 0) {
+                    g_onTimeRecordSlot = slot;
+                    g_onTimeRecord = record;
+                }
+            }
+        }
+
+        if (g_onTimeRecordSlot != -1) {
+            return;
+        }
+    }
 
-	buffer[0] = ONTIME_MAGIC;
-	buffer[1] = time;
-	buffer[2] = time;
+    memset(&g_onTimeRecord, 0, sizeof(OnTimeRecord));
+    g_onTimeRecord.sequence = 0xFFFF;
 
-	buffer[3] = ONTIME_MAGIC;
-	buffer[4] = time;
-	buffer[5] = time;
+    if (eeprom::g_testResult == psu::TEST_OK) {
+        for (int type = 0; type <= CH_MAX; ++type) {
+            g_onTimeRecord.counters[type] = read_old_total_on_time(type);
+        }
+    }
+}
 
-	return eeprom::write((uint8_t *)buffer, sizeof(buffer),
-		eeprom::EEPROM_ONTIME_START_ADDRESS + type * eeprom::EEPROM_ONTIME_SIZE);
+uint32_t readTotalOnTime(int type) {
+    if (!g_onTimeRecordLoaded) {
+        load_ontime_record();
+    }
+    return g_onTimeRecord.counters[type];
 }
 
+/// Writes all on-time counters at once. EEPROM write cycle is finished
+/// in the background, so this doesn't block the main loop.
+static void write_ontime_record() {
+    if (eeprom::g_testResult != psu::TEST_OK) {
+        return;
+    }
+
+    if (!g_onTimeRecordLoaded) {
+        load_ontime_record();
+    }
+
+    g_onTimeRecord.counters[ontime::ON_TIME_COUNTER_POWER] = g_powerOnTimeCounter.getTotalTime();
+    for (int i = 0; i < CH_NUM; ++i) {
+        g_onTimeRecord.counters[ontime::ON_TIME_COUNTER_CH1 + i] = Channel::get(i).onTimeCounter.getTotalTime();
+    }
+
+    g_onTimeRecord.magic = ONTIME_MAGIC;
+    ++g_onTimeRecord.sequence;
+    g_onTimeRecord.checksum = calc_ontime_record_checksum(g_onTimeRecord);
+
+    g_onTimeRecordSlot = (g_onTimeRecordSlot + 1) % ONTIME_RECORD_NUM_SLOTS;
+
+    eeprom::writeAsync((const uint8_t *)&g_onTimeRecord, sizeof(OnTimeRecord),
+        eeprom::EEPROM_ONTIME_RECORD_START_ADDRESS + g_onTimeRecordSlot * sizeof(OnTimeRecord));
+}
+
+void tick(uint32_t tick_usec) {
+    if (g_onTimeWriteInterval.test(tick_usec)) {
+        write_ontime_record();
+    }
+}
+
+#ifdef EEZ_PSU_SIMULATOR
+
+void resetCache() {
+    g_newestSlotCacheSize = 0;
+    g_onTimeRecordSlot = -1;
+    g_onTimeRecordLoaded = false;
+}
+
+#endif
+
 bool enableOutputProtectionCouple(bool enable) {
     int outputProtectionCouple = enable ? 1 : 0;
 
@@ -583,6 +839,10 @@ bool setDisplayState(unsigned newState) {
     return true;
 }
 
+uint16_t getGeneration() {
+    return g_generation;
+}
+
 }
 }
 } // namespace eez::psu::persist_conf
\ No newline at end of file
@@ -36,10 +36,12 @@ namespace psu {
 /// Store/restore of persistent configuration data (device configuration, calibration parameters, profiles) using external EEPROM.
 namespace persist_conf {
 
-/// Header of the every block stored in EEPROM. It contains checksum and version.
+/// Header of the every block stored in EEPROM. It contains checksum, version and
+/// sequence number used to find the newest copy when block is stored in multiple slots.
 struct BlockHeader {
     uint32_t checksum;
     uint16_t version;
+    uint16_t sequence;
 };
 
 /// Device binary flags stored in DeviceConfiguration.
@@ -99,7 +101,9 @@ struct DeviceConfiguration2 {
     uint8_t encoderMovingSpeedDown;
     uint8_t encoderMovingSpeedUp;
     uint8_t displayBrightness;
-    uint8_t reserverd[93];
+    uint8_t reserved1;
+    uint16_t statusBroadcastPeriod; // in 100 ms units, 0 means broadcast is disabled
+    uint8_t reserverd[90];
 };
 
 extern DeviceConfiguration devConf;
@@ -128,6 +132,8 @@ bool isClickSoundEnabled();
 bool enableEthernet(bool enable);
 bool isEthernetEnabled();
 
+bool setStatusBroadcastPeriod(uint16_t period);
+
 bool readSystemDate(uint8_t &year, uint8_t &month, uint8_t &day);
 void writeSystemDate(uint8_t year, uint8_t month, uint8_t day);
 
@@ -150,7 +156,15 @@ bool loadProfile(int location, profile::Parameters *profile);
 bool saveProfile(int location, profile::Parameters *profile);
 
 uint32_t readTotalOnTime(int type);
-bool writeTotalOnTime(int type, uint32_t time);
+
+#ifdef EEZ_PSU_SIMULATOR
+/// Forgets the newest slots and the on-time record found so far,
+/// so they are searched again after EEPROM content is replaced.
+void resetCache();
+#endif
+
+/// Writes on-time counters every WRITE_ONTIME_INTERVAL minutes.
+void tick(uint32_t tick_usec);
 
 bool enableOutputProtectionCouple(bool enable);
 bool isOutputProtectionCoupleEnabled();
@@ -167,6 +181,10 @@ bool setEncoderSettings(uint8_t confirmationMode, uint8_t movingSpeedDown, uint8
 
 bool setDisplayState(unsigned state);
 
+/// Generation of the persistent configuration, it is incremented
+/// every time configuration is loaded or saved.
+uint16_t getGeneration();
+
 }
 }
 } // namespace eez::psu::persist_conf
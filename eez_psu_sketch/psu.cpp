@@ -145,9 +145,6 @@ void init() {
     list::init();
 
 #if OPTION_ETHERNET
-#if OPTION_DISPLAY
-    gui::showEthernetInit();
-#endif
 	ethernet::init();
 #else
 	DebugTrace("Ethernet initialization skipped!");
@@ -184,7 +181,12 @@ static bool testShield() {
 
 	result &= rtc::test();
     result &= datetime::test();
-    result &= eeprom::test();
+    if (g_isBooted) {
+        result &= eeprom::test();
+    } else {
+        // already tested in init, before the configuration was loaded
+        result &= eeprom::g_testResult != TEST_FAILED;
+    }
 #ifdef OPTION_SD_CARD
     result &= sd_card::test();
 #endif
@@ -574,6 +576,7 @@ void boot() {
 //    DebugTraceF("%d", sizeof(BlockHeader));                                         // 8
 //    DebugTraceF("%d", offsetof(BlockHeader, checksum));                             // 0
 //    DebugTraceF("%d", offsetof(BlockHeader, version));                              // 4
+//    DebugTraceF("%d", offsetof(BlockHeader, sequence));                             // 6
 //
 //    DebugTraceF("%d", sizeof(DeviceFlags));                                         // 4
 //
@@ -678,6 +681,27 @@ void boot() {
 //    DebugTraceF("%d", offsetof(Event, eventId));                                    // 4
 }
 
+#ifdef EEZ_PSU_SIMULATOR
+
+void reloadConf() {
+    persist_conf::resetCache();
+
+    g_powerOnTimeCounter.init();
+    for (int i = 0; i < CH_NUM; ++i) {
+        Channel::get(i).onTimeCounter.init();
+    }
+
+    loadConf();
+
+    event_queue::init();
+
+    if (!autoRecall()) {
+        psuReset();
+    }
+}
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool powerUp() {
@@ -927,6 +951,8 @@ void tick() {
     
     profile::tick(tick_usec);
 
+    persist_conf::tick(tick_usec);
+
 #if OPTION_DISPLAY
 #ifdef EEZ_PSU_SIMULATOR
     if (simulator::front_panel::isOpened()) {
@@ -1257,25 +1283,19 @@ void startMasterSync() {
 }
 
 void updateMasterSync() {
-#if 0
-	bool shouldBeStarted = true;
-
-    for (int i = 0; i < CH_NUM; ++i) {
-		if (Channel::get(i).isLowRippleEnabled()) {
-			shouldBeStarted = false;
-			break;
-		}
-    }
+    // SYNC pin is shared between the sync clock and the trigger output
+	bool shouldBeStarted = trigger::getOutputSource() == trigger::OUTPUT_SOURCE_NONE;
 
 	if (shouldBeStarted != g_masterSyncStarted) {
 		if (shouldBeStarted) {
-			TC_Start(g_chTC, g_chNo);
+			startMasterSync();
 		} else {
 			TC_Stop(g_chTC, g_chNo);
+			pinMode(SYNC_MASTER, OUTPUT);
+			digitalWrite(SYNC_MASTER, LOW);
+			g_masterSyncStarted = false;
 		}
-		g_masterSyncStarted = shouldBeStarted;
 	}
-#endif
 }
 
 #endif
@@ -61,6 +61,11 @@ enum TestResult {
 
 void boot();
 
+#ifdef EEZ_PSU_SIMULATOR
+/// Reads again everything boot reads from EEPROM and recalls the power up profile.
+void reloadConf();
+#endif
+
 extern bool g_isBooted;
 
 bool powerUp();
@@ -75,6 +75,44 @@ static scpi_result_t calibration_level(scpi_t * context, calibration::Value &cal
 
     return SCPI_RES_OK;
 }
+
+static scpi_result_t calibration_point(scpi_t * context, calibration::Value &calibrationValue) {
+    if (!calibration::isEnabled()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_CALIBRATION_STATE_IS_OFF);
+        return SCPI_RES_ERR;
+    }
+
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, 0, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (param.unit != SCPI_UNIT_NONE && param.unit != (calibrationValue.voltOrCurr ? SCPI_UNIT_VOLT : SCPI_UNIT_AMPER)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+        return SCPI_RES_ERR;
+    }
+
+    if (!calibrationValue.min_set) {
+        SCPI_ErrorPush(context, SCPI_ERROR_BAD_SEQUENCE_OF_CALIBRATION_COMMANDS);
+        return SCPI_RES_ERR;
+    }
+
+    float value = (float)param.value;
+    if (!calibrationValue.isPointLevelInRange(value)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    if (!calibrationValue.canSetPoint(value)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+        return SCPI_RES_ERR;
+    }
+
+    calibrationValue.setPointLevel(value);
+
+    return SCPI_RES_OK;
+}
+
 static scpi_result_t calibration_data(scpi_t * context, calibration::Value &calibrationValue) {
     if (!calibration::isEnabled()) {
         SCPI_ErrorPush(context, SCPI_ERROR_CALIBRATION_STATE_IS_OFF);
@@ -188,6 +226,10 @@ scpi_result_t scpi_cmd_calibrationCurrentLevel(scpi_t * context) {
     return calibration_level(context, calibration::g_current);
 }
 
+scpi_result_t scpi_cmd_calibrationCurrentPoint(scpi_t * context) {
+    return calibration_point(context, calibration::g_current);
+}
+
 scpi_result_t scpi_cmd_calibrationPasswordNew(scpi_t * context) {
     if (!check_password(context)) {
         return SCPI_RES_ERR;
@@ -324,6 +366,10 @@ scpi_result_t scpi_cmd_calibrationVoltageLevel(scpi_t * context) {
     return calibration_level(context, calibration::g_voltage);;
 }
 
+scpi_result_t scpi_cmd_calibrationVoltagePoint(scpi_t * context) {
+    return calibration_point(context, calibration::g_voltage);
+}
+
 }
 }
 } // namespace eez::psu::scpi
\ No newline at end of file
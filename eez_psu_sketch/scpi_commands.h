@@ -26,6 +26,7 @@
     SCPI_COMMAND("CALibration:CLEar", scpi_cmd_calibrationClear) \
     SCPI_COMMAND("CALibration:CURRent[:DATA]", scpi_cmd_calibrationCurrentData) \
     SCPI_COMMAND("CALibration:CURRent:LEVel", scpi_cmd_calibrationCurrentLevel) \
+    SCPI_COMMAND("CALibration:CURRent:POINt", scpi_cmd_calibrationCurrentPoint) \
     SCPI_COMMAND("CALibration:PASSword:NEW", scpi_cmd_calibrationPasswordNew) \
     SCPI_COMMAND("CALibration:REMark", scpi_cmd_calibrationRemark) \
     SCPI_COMMAND("CALibration:REMark?", scpi_cmd_calibrationRemarkQ) \
@@ -34,6 +35,7 @@
     SCPI_COMMAND("CALibration:STATe?", scpi_cmd_calibrationStateQ) \
     SCPI_COMMAND("CALibration:VOLTage[:DATA]", scpi_cmd_calibrationVoltageData) \
     SCPI_COMMAND("CALibration:VOLTage:LEVel", scpi_cmd_calibrationVoltageLevel) \
+    SCPI_COMMAND("CALibration:VOLTage:POINt", scpi_cmd_calibrationVoltagePoint) \
     SCPI_COMMAND("*CLS", scpi_cmd_coreCls) \
     SCPI_COMMAND("*ESE", scpi_cmd_coreEse) \
     SCPI_COMMAND("*ESE?", scpi_cmd_coreEseQ) \
@@ -75,6 +77,7 @@
     SCPI_COMMAND("MEASure[:SCALar]:CURRent[:DC]?", scpi_cmd_measureScalarCurrentDcQ) \
     SCPI_COMMAND("MEASure[:SCALar]:POWer[:DC]?", scpi_cmd_measureScalarPowerDcQ) \
     SCPI_COMMAND("MEASure[:SCALar]:TEMPerature[:THERmistor][:DC]?", scpi_cmd_measureScalarTemperatureThermistorDcQ) \
+    SCPI_COMMAND("MEASure[:SCALar]:TRENd?", scpi_cmd_measureScalarTrendQ) \
     SCPI_COMMAND("MEMory:NSTates?", scpi_cmd_memoryNstatesQ) \
     SCPI_COMMAND("MEMory:STATe:CATalog?", scpi_cmd_memoryStateCatalogQ) \
     SCPI_COMMAND("MEMory:STATe:DELete", scpi_cmd_memoryStateDelete) \
@@ -108,7 +111,20 @@
     SCPI_COMMAND("SIMUlator:RPOL?", scpi_cmd_simulatorRpolQ) \
     SCPI_COMMAND("SIMUlator:TEMPerature", scpi_cmd_simulatorTemperature) \
     SCPI_COMMAND("SIMUlator:TEMPerature?", scpi_cmd_simulatorTemperatureQ) \
+    SCPI_COMMAND("SIMUlator:CRC32:TEST?", scpi_cmd_simulatorCrc32TestQ) \
+    SCPI_COMMAND("SIMUlator:CRC32:BENChmark?", scpi_cmd_simulatorCrc32BenchmarkQ) \
     SCPI_COMMAND("SIMUlator:GUI", scpi_cmd_simulatorGui) \
+    SCPI_COMMAND("SIMUlator:GUI:HEADless", scpi_cmd_simulatorGuiHeadless) \
+    SCPI_COMMAND("SIMUlator:GUI:TOUCh", scpi_cmd_simulatorGuiTouch) \
+    SCPI_COMMAND("SIMUlator:GUI:TOUCh:RELease", scpi_cmd_simulatorGuiTouchRelease) \
+    SCPI_COMMAND("SIMUlator:GUI:ENCoder", scpi_cmd_simulatorGuiEncoder) \
+    SCPI_COMMAND("SIMUlator:GUI:SCReenshot", scpi_cmd_simulatorGuiScreenshot) \
+    SCPI_COMMAND("SIMUlator:GUI:STATistics?", scpi_cmd_simulatorGuiStatisticsQ) \
+    SCPI_COMMAND("SIMUlator:GUI:STATistics:RESet", scpi_cmd_simulatorGuiStatisticsReset) \
+    SCPI_COMMAND("SIMUlator:SPI:STATistics?", scpi_cmd_simulatorSpiStatisticsQ) \
+    SCPI_COMMAND("SIMUlator:SPI:STATistics:RESet", scpi_cmd_simulatorSpiStatisticsReset) \
+    SCPI_COMMAND("SIMUlator:EEPROM:SNAPshot", scpi_cmd_simulatorEepromSnapshot) \
+    SCPI_COMMAND("SIMUlator:EEPROM:RESTore", scpi_cmd_simulatorEepromRestore) \
     SCPI_COMMAND("SIMUlator:EXIT", scpi_cmd_simulatorExit) \
     SCPI_COMMAND("SIMUlator:QUIT", scpi_cmd_simulatorQuit) \
     SCPI_COMMAND("[SOURce#]:CURRent[:LEVel][:IMMediate][:AMPLitude]", scpi_cmd_sourceCurrentLevelImmediateAmplitude) \
@@ -193,6 +209,19 @@
     SCPI_COMMAND("STATus:OPERation:INSTrument:ISUMmary#:ENABle", scpi_cmd_statusOperationInstrumentIsummaryEnable) \
     SCPI_COMMAND("STATus:OPERation:INSTrument:ISUMmary#:ENABle?", scpi_cmd_statusOperationInstrumentIsummaryEnableQ) \
     SCPI_COMMAND("STATus:PREset", scpi_cmd_statusPreset) \
+    SCPI_COMMAND("STATus:NOTify:OPERation:ENABle", scpi_cmd_statusNotifyOperationEnable) \
+    SCPI_COMMAND("STATus:NOTify:OPERation:ENABle?", scpi_cmd_statusNotifyOperationEnableQ) \
+    SCPI_COMMAND("STATus:NOTify:QUEStionable:ENABle", scpi_cmd_statusNotifyQuestionableEnable) \
+    SCPI_COMMAND("STATus:NOTify:QUEStionable:ENABle?", scpi_cmd_statusNotifyQuestionableEnableQ) \
+    SCPI_COMMAND("STATus:NOTify:OPERation:INSTrument:ISUMmary#:ENABle", scpi_cmd_statusNotifyOperationInstrumentIsummaryEnable) \
+    SCPI_COMMAND("STATus:NOTify:OPERation:INSTrument:ISUMmary#:ENABle?", scpi_cmd_statusNotifyOperationInstrumentIsummaryEnableQ) \
+    SCPI_COMMAND("STATus:NOTify:QUEStionable:INSTrument:ISUMmary#:ENABle", scpi_cmd_statusNotifyQuestionableInstrumentIsummaryEnable) \
+    SCPI_COMMAND("STATus:NOTify:QUEStionable:INSTrument:ISUMmary#:ENABle?", scpi_cmd_statusNotifyQuestionableInstrumentIsummaryEnableQ) \
+    SCPI_COMMAND("STATus:NOTify:MEASure#:VOLTage:DEADband", scpi_cmd_statusNotifyMeasureVoltageDeadband) \
+    SCPI_COMMAND("STATus:NOTify:MEASure#:VOLTage:DEADband?", scpi_cmd_statusNotifyMeasureVoltageDeadbandQ) \
+    SCPI_COMMAND("STATus:NOTify:MEASure#:CURRent:DEADband", scpi_cmd_statusNotifyMeasureCurrentDeadband) \
+    SCPI_COMMAND("STATus:NOTify:MEASure#:CURRent:DEADband?", scpi_cmd_statusNotifyMeasureCurrentDeadbandQ) \
+    SCPI_COMMAND("STATus:NOTify:CLEar", scpi_cmd_statusNotifyClear) \
     SCPI_COMMAND("SYSTem:CAPability?", scpi_cmd_systemCapabilityQ) \
     SCPI_COMMAND("SYSTem:ERRor[:NEXT]?", scpi_cmd_systemErrorNextQ) \
     SCPI_COMMAND("SYSTem:ERRor:COUNt?", scpi_cmd_systemErrorCountQ) \
@@ -241,16 +270,23 @@
     SCPI_COMMAND("SYSTem:PASSword:CALibrate:RESet", scpi_cmd_systemPasswordCalibrateReset) \
     SCPI_COMMAND("SYSTem:KLOCk", scpi_cmd_systemKlock) \
     SCPI_COMMAND("SYSTem:COMMunicate:RLSTate", scpi_cmd_systemCommunicateRlstate) \
+    SCPI_COMMAND("SYSTem:COMMunicate:LAN:STATus:PERiod", scpi_cmd_systemCommunicateLanStatusPeriod) \
+    SCPI_COMMAND("SYSTem:COMMunicate:LAN:STATus:PERiod?", scpi_cmd_systemCommunicateLanStatusPeriodQ) \
     SCPI_COMMAND("SYSTem:LOCal", scpi_cmd_systemLocal) \
     SCPI_COMMAND("SYSTem:REMote", scpi_cmd_systemRemote) \
     SCPI_COMMAND("SYSTem:RWLock", scpi_cmd_systemRwlock) \
     SCPI_COMMAND("TRIGger[:SEQuence][:IMMediate]", scpi_cmd_triggerSequenceImmediate) \
     SCPI_COMMAND("TRIGger[:SEQuence]:DELay", scpi_cmd_triggerSequenceDelay) \
     SCPI_COMMAND("TRIGger[:SEQuence]:DELay?", scpi_cmd_triggerSequenceDelayQ) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:LATency?", scpi_cmd_triggerSequenceLatencyQ) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SLOPe", scpi_cmd_triggerSequenceSlope) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SLOPe?", scpi_cmd_triggerSequenceSlopeQ) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SOURce", scpi_cmd_triggerSequenceSource) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SOURce?", scpi_cmd_triggerSequenceSourceQ) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:STEP:SOURce", scpi_cmd_triggerSequenceStepSource) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:STEP:SOURce?", scpi_cmd_triggerSequenceStepSourceQ) \
+    SCPI_COMMAND("TRIGger:OUTPut:SOURce", scpi_cmd_triggerOutputSource) \
+    SCPI_COMMAND("TRIGger:OUTPut:SOURce?", scpi_cmd_triggerOutputSourceQ) \
     SCPI_COMMAND("INITiate", scpi_cmd_initiate) \
     SCPI_COMMAND("INITiate:CONTinuous", scpi_cmd_initiateContinuous) \
     SCPI_COMMAND("INITiate:CONTinuous?", scpi_cmd_initiateContinuousQ) \
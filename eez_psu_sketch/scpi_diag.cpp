@@ -47,6 +47,10 @@ static void print_calibration_value(scpi_t * context, char *buffer, calibration:
     if (value.min_set) { strcpy_P(buffer, prefix); strcat_P(buffer, PSTR("_min=")); strcat_value(buffer, value.min_val, FLOAT_TO_STR_NUM_DECIMAL_DIGITS); SCPI_ResultText(context, buffer); }
     if (value.mid_set) { strcpy_P(buffer, prefix); strcat_P(buffer, PSTR("_mid=")); strcat_value(buffer, value.mid_val, FLOAT_TO_STR_NUM_DECIMAL_DIGITS); SCPI_ResultText(context, buffer); }
     if (value.max_set) { strcpy_P(buffer, prefix); strcat_P(buffer, PSTR("_max=")); strcat_value(buffer, value.max_val, FLOAT_TO_STR_NUM_DECIMAL_DIGITS); SCPI_ResultText(context, buffer); }
+    for (int k = 0; k < value.numPoints; ++k) {
+        strcpy_P(buffer, prefix); strcat_P(buffer, PSTR("_point=")); strcat_value(buffer, value.point_dac[k], FLOAT_TO_STR_NUM_DECIMAL_DIGITS);
+        strcat_P(buffer, PSTR(" ")); strcat_value(buffer, value.point_val[k], FLOAT_TO_STR_NUM_DECIMAL_DIGITS); SCPI_ResultText(context, buffer);
+    }
 
     strcpy_P(buffer, prefix); strcat_P(buffer, PSTR("_level="));
     switch (value.level) {
@@ -54,6 +58,7 @@ static void print_calibration_value(scpi_t * context, char *buffer, calibration:
     case calibration::LEVEL_MIN:  strcat_P(buffer, PSTR("min") ); break;
     case calibration::LEVEL_MID:  strcat_P(buffer, PSTR("mid") ); break;
     case calibration::LEVEL_MAX:  strcat_P(buffer, PSTR("max") ); break;
+    case calibration::LEVEL_POINT: strcat_P(buffer, PSTR("point")); break;
     }
     SCPI_ResultText(context, buffer);
 
@@ -128,6 +133,11 @@ scpi_result_t scpi_cmd_diagnosticInformationCalibrationQ(scpi_t * context) {
             strcpy_P(buffer, PSTR("u_max_adc=")  ); util::strcatVoltage(buffer, channel->cal_conf.u.max.adc, 6); SCPI_ResultText(context, buffer);
 			strcpy_P(buffer, PSTR("u_min_range=")  ); util::strcatVoltage(buffer, channel->cal_conf.u.minPossible, 6); SCPI_ResultText(context, buffer);
 			strcpy_P(buffer, PSTR("u_max_range=")  ); util::strcatVoltage(buffer, channel->cal_conf.u.maxPossible, 6); SCPI_ResultText(context, buffer);
+            for (int k = 0; k < channel->cal_conf.u_num_extra_points; ++k) {
+                strcpy_P(buffer, PSTR("u_point_level=")); util::strcatVoltage(buffer, channel->cal_conf.u_extra_points[k].dac, 6); SCPI_ResultText(context, buffer);
+                strcpy_P(buffer, PSTR("u_point_data=") ); util::strcatVoltage(buffer, channel->cal_conf.u_extra_points[k].val, 6); SCPI_ResultText(context, buffer);
+                strcpy_P(buffer, PSTR("u_point_adc=")  ); util::strcatVoltage(buffer, channel->cal_conf.u_extra_points[k].adc, 6); SCPI_ResultText(context, buffer);
+            }
         }
 
         strcpy_P(buffer, PSTR("i_cal_params_exists=")); util::strcatInt(buffer, channel->cal_conf.flags.i_cal_params_exists); SCPI_ResultText(context, buffer);
@@ -143,6 +153,11 @@ scpi_result_t scpi_cmd_diagnosticInformationCalibrationQ(scpi_t * context) {
             strcpy_P(buffer, PSTR("i_max_adc=")  ); util::strcatCurrent(buffer, channel->cal_conf.i.max.adc, 6); SCPI_ResultText(context, buffer);
 			strcpy_P(buffer, PSTR("i_min_range=")  ); util::strcatCurrent(buffer, channel->cal_conf.i.minPossible, 6); SCPI_ResultText(context, buffer);
 			strcpy_P(buffer, PSTR("i_max_range=")  ); util::strcatCurrent(buffer, channel->cal_conf.i.maxPossible, 6); SCPI_ResultText(context, buffer);
+            for (int k = 0; k < channel->cal_conf.i_num_extra_points; ++k) {
+                strcpy_P(buffer, PSTR("i_point_level=")); util::strcatCurrent(buffer, channel->cal_conf.i_extra_points[k].dac, 6); SCPI_ResultText(context, buffer);
+                strcpy_P(buffer, PSTR("i_point_data=") ); util::strcatCurrent(buffer, channel->cal_conf.i_extra_points[k].val, 6); SCPI_ResultText(context, buffer);
+                strcpy_P(buffer, PSTR("i_point_adc=")  ); util::strcatCurrent(buffer, channel->cal_conf.i_extra_points[k].adc, 6); SCPI_ResultText(context, buffer);
+            }
         }
     }
 
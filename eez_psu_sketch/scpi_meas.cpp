@@ -27,6 +27,14 @@ namespace scpi {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static scpi_choice_def_t trendTierChoice[] = {
+    { "SECond", trend::TIER_SECONDS },
+    { "MINute", trend::TIER_MINUTES },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 scpi_result_t scpi_cmd_measureScalarCurrentDcQ(scpi_t * context) {
     Channel *channel = param_channel(context);
     if (!channel) {
@@ -79,6 +87,33 @@ scpi_result_t scpi_cmd_measureScalarTemperatureThermistorDcQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_measureScalarTrendQ(scpi_t * context) {
+    int32_t tier;
+    if (!SCPI_ParamChoice(context, trendTierChoice, &tier, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    Channel *channel = param_channel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    // for each bucket, from the oldest to the newest: Umin, Umax, Umean, Imin, Imax, Imean
+    trend::History &history = channel->trend;
+    int numBuckets = history.getNumBuckets((trend::Tier)tier);
+    for (int i = 0; i < numBuckets; ++i) {
+        const trend::Bucket &bucket = history.getBucket((trend::Tier)tier, i);
+        SCPI_ResultFloat(context, history.decodeU(bucket.uMin));
+        SCPI_ResultFloat(context, history.decodeU(bucket.uMax));
+        SCPI_ResultFloat(context, history.decodeU(bucket.uMean));
+        SCPI_ResultFloat(context, history.decodeI(bucket.iMin));
+        SCPI_ResultFloat(context, history.decodeI(bucket.iMax));
+        SCPI_ResultFloat(context, history.decodeI(bucket.iMean));
+    }
+
+    return SCPI_RES_OK;
+}
+
 }
 }
 } // namespace eez::psu::scpi
\ No newline at end of file
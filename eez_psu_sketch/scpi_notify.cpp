@@ -0,0 +1,166 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+#include "psu.h"
+#include "scpi_psu.h"
+#include "channel_dispatcher.h"
+
+namespace eez {
+namespace psu {
+namespace scpi {
+
+static scpi_psu_notify_t *get_notify(scpi_t *context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+    return &psu_context->notify;
+}
+
+static void notify_write(scpi_t *context, const char *frame) {
+    context->interface->write(context, frame, strlen(frame));
+}
+
+static bool notify_is_status_subscribed(scpi_psu_notify_t *notify) {
+    if (notify->operEnable || notify->quesEnable) {
+        return true;
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (notify->operIsumEnable[i] || notify->quesIsumEnable[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void notify_status_tick(scpi_t *context, scpi_psu_notify_t *notify) {
+    if (!notify_is_status_subscribed(notify)) {
+        return;
+    }
+
+    scpi_reg_val_t oper = reg_get(context, SCPI_PSU_REG_OPER_COND) & notify->operEnable;
+    scpi_reg_val_t ques = reg_get(context, SCPI_PSU_REG_QUES_COND) & notify->quesEnable;
+
+    scpi_reg_val_t operIsum[2];
+    scpi_reg_val_t quesIsum[2];
+    operIsum[0] = reg_get(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_COND1) & notify->operIsumEnable[0];
+    quesIsum[0] = reg_get(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_COND1) & notify->quesIsumEnable[0];
+    operIsum[1] = reg_get(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_COND2) & notify->operIsumEnable[1];
+    quesIsum[1] = reg_get(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_COND2) & notify->quesIsumEnable[1];
+
+    if (notify->statusReported &&
+        oper == notify->lastOper && ques == notify->lastQues &&
+        operIsum[0] == notify->lastOperIsum[0] && quesIsum[0] == notify->lastQuesIsum[0] &&
+        operIsum[1] == notify->lastOperIsum[1] && quesIsum[1] == notify->lastQuesIsum[1]) {
+        return;
+    }
+
+    notify->statusReported = true;
+    notify->lastOper = oper;
+    notify->lastQues = ques;
+    notify->lastOperIsum[0] = operIsum[0];
+    notify->lastQuesIsum[0] = quesIsum[0];
+    notify->lastOperIsum[1] = operIsum[1];
+    notify->lastQuesIsum[1] = quesIsum[1];
+
+    // **NTF:STAT <oper>,<ques>[,<oper_isum1>,<ques_isum1>[,<oper_isum2>,<ques_isum2>]]
+    char frame[64];
+    char *p = frame;
+    p += sprintf_P(p, PSTR("**NTF:STAT %u,%u"), (unsigned)oper, (unsigned)ques);
+    for (int i = 0; i < MIN(CH_NUM, 2); ++i) {
+        p += sprintf_P(p, PSTR(",%u,%u"), (unsigned)operIsum[i], (unsigned)quesIsum[i]);
+    }
+    strcpy_P(p, PSTR("\r\n"));
+
+    notify_write(context, frame);
+}
+
+static bool notify_is_outside_deadband(float value, float last, float deadband) {
+    if (deadband <= 0) {
+        return false;
+    }
+    return util::isNaN(last) || fabsf(value - last) >= deadband;
+}
+
+static void notify_measurement_tick(scpi_t *context, scpi_psu_notify_t *notify, uint32_t tick_usec) {
+    if (tick_usec - notify->lastMeasTick < NOTIFY_MEAS_MIN_INTERVAL_MS * 1000UL) {
+        return;
+    }
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        if (notify->uDeadband[i] <= 0 && notify->iDeadband[i] <= 0) {
+            continue;
+        }
+
+        Channel &channel = Channel::get(i);
+        float u = channel_dispatcher::getUMon(channel);
+        float iMon = channel_dispatcher::getIMon(channel);
+
+        if (!notify_is_outside_deadband(u, notify->uLast[i], notify->uDeadband[i]) &&
+            !notify_is_outside_deadband(iMon, notify->iLast[i], notify->iDeadband[i])) {
+            continue;
+        }
+
+        notify->uLast[i] = u;
+        notify->iLast[i] = iMon;
+        notify->lastMeasTick = tick_usec;
+
+        // **NTF:MEAS<ch> <u_mon>,<i_mon>
+        char frame[64];
+        sprintf_P(frame, PSTR("**NTF:MEAS%d "), i + 1);
+        util::strcatFloat(frame, u);
+        strcat_P(frame, PSTR(","));
+        util::strcatFloat(frame, iMon);
+        strcat_P(frame, PSTR("\r\n"));
+
+        notify_write(context, frame);
+    }
+}
+
+/**
+* Cancel all subscriptions of the SCPI connection.
+*/
+void notify_reset(scpi_t *context) {
+    scpi_psu_notify_t *notify = get_notify(context);
+
+    notify->operEnable = 0;
+    notify->quesEnable = 0;
+    for (int i = 0; i < 2; ++i) {
+        notify->operIsumEnable[i] = 0;
+        notify->quesIsumEnable[i] = 0;
+    }
+    notify->statusReported = false;
+
+    for (int i = 0; i < CH_MAX; ++i) {
+        notify->uDeadband[i] = 0;
+        notify->iDeadband[i] = 0;
+        notify->uLast[i] = NAN;
+        notify->iLast[i] = NAN;
+    }
+}
+
+/**
+* Send notification frames for the changes the SCPI connection subscribed to.
+* Called from the main loop by the owner of the connection (serial, ethernet).
+*/
+void notify_tick(scpi_t *context, uint32_t tick_usec) {
+    scpi_psu_notify_t *notify = get_notify(context);
+    notify_status_tick(context, notify);
+    notify_measurement_tick(context, notify, tick_usec);
+}
+
+}
+}
+} // namespace eez::psu::scpi
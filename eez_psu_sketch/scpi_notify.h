@@ -0,0 +1,63 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace scpi {
+
+/// Change notification subscription of the single SCPI connection.
+/// Instead of polling STAT:...:COND? and MEAS? the host subscribes
+/// to the condition register bits and measurement deadbands it is
+/// interested in and receives asynchronous `**NTF` frames.
+struct scpi_psu_notify_t {
+    /// STAT:NOT:OPER:ENAB mask, applied on STAT:OPER:COND
+    scpi_reg_val_t operEnable;
+    /// STAT:NOT:QUES:ENAB mask, applied on STAT:QUES:COND
+    scpi_reg_val_t quesEnable;
+    /// STAT:NOT:OPER:INST:ISUM#:ENAB masks
+    scpi_reg_val_t operIsumEnable[2];
+    /// STAT:NOT:QUES:INST:ISUM#:ENAB masks
+    scpi_reg_val_t quesIsumEnable[2];
+
+    /// STAT:NOT:VOLT#:DEAD, 0 means not subscribed
+    float uDeadband[CH_MAX];
+    /// STAT:NOT:CURR#:DEAD, 0 means not subscribed
+    float iDeadband[CH_MAX];
+
+    /// Last reported (masked) condition registers,
+    /// valid only if statusReported is set
+    bool statusReported;
+    scpi_reg_val_t lastOper;
+    scpi_reg_val_t lastQues;
+    scpi_reg_val_t lastOperIsum[2];
+    scpi_reg_val_t lastQuesIsum[2];
+
+    /// Last reported measurements, NAN if not reported yet
+    float uLast[CH_MAX];
+    float iLast[CH_MAX];
+    uint32_t lastMeasTick;
+};
+
+void notify_reset(scpi_t *context);
+void notify_tick(scpi_t *context, uint32_t tick_usec);
+
+}
+}
+} // namespace eez::psu::scpi
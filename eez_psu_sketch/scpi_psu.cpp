@@ -71,6 +71,8 @@ void init(scpi_t &scpi_context,
         input_buffer, input_buffer_length, error_queue_data, error_queue_size);
 
     scpi_context.user_context = &scpi_psu_context;
+
+    notify_reset(&scpi_context);
 }
 
 void input(scpi_t &scpi_context, char ch) {
@@ -108,6 +110,48 @@ void input(scpi_t &scpi_context, const char *str, size_t size) {
     }
 }
 
+char *getInputBuffer(scpi_t &scpi_context, size_t &size) {
+    int len;
+    char *buffer = SCPI_InputBuffer(&scpi_context, &len);
+    if (len <= 0) {
+        // unterminated command doesn't fit into the input buffer, drop it
+        SCPI_ErrorPush(&scpi_context, SCPI_ERROR_INPUT_BUFFER_OVERRUN);
+        scpi_context.buffer.position = 0;
+        scpi_context.buffer.data[0] = 0;
+
+        scpi_psu_t *psu_context = (scpi_psu_t *)scpi_context.user_context;
+        psu_context->input_overrun = true;
+
+        buffer = SCPI_InputBuffer(&scpi_context, &len);
+    }
+    size = (size_t)len;
+    return buffer;
+}
+
+void inputCommit(scpi_t &scpi_context, size_t size) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)scpi_context.user_context;
+    if (psu_context->input_overrun) {
+        // discard the rest of the dropped command, up to and including the terminator
+        int len;
+        char *buffer = SCPI_InputBuffer(&scpi_context, &len);
+        char *end = (char *)memchr(buffer, '\n', size);
+        if (!end) {
+            return;
+        }
+
+        psu_context->input_overrun = false;
+
+        ++end;
+        size -= end - buffer;
+        if (size == 0) {
+            return;
+        }
+        memmove(buffer, end, size);
+    }
+
+    SCPI_InputCommit(&scpi_context, (int)size);
+}
+
 void printError(int_fast16_t err) {
     sound::playBeep();
 
@@ -20,6 +20,7 @@
 
 #include "scpi_regs.h"
 #include "scpi_params.h"
+#include "scpi_notify.h"
 
 namespace eez {
 namespace psu {
@@ -30,6 +31,9 @@ namespace scpi {
 struct scpi_psu_t {
     scpi_reg_val_t *registers;
     uint8_t selected_channel_index;
+    scpi_psu_notify_t notify;
+    /// Input buffer overrun happened, received data is discarded up to the next terminator.
+    bool input_overrun;
 };
 
 void init(scpi_t &scpi_context,
@@ -43,6 +47,14 @@ void init(scpi_t &scpi_context,
 void input(scpi_t &scpi_context, char ch);
 void input(scpi_t &scpi_context, const char *str, size_t size);
 
+/// Returns free part of the SCPI input buffer, so data can be received directly into it.
+/// If buffer is full (i.e. it contains unterminated command) then input buffer overrun
+/// error is reported and that command is dropped, together with the rest of it
+/// received later (see inputCommit).
+char *getInputBuffer(scpi_t &scpi_context, size_t &size);
+/// Process size bytes received into the buffer returned by getInputBuffer.
+void inputCommit(scpi_t &scpi_context, size_t size);
+
 void printError(int_fast16_t err);
 
 void resultChoiceName(scpi_t *context, scpi_choice_def_t *choice, int tag);
@@ -25,6 +25,7 @@
 #include "chips.h"
 #if OPTION_DISPLAY
 #include "front_panel/control.h"
+#include "front_panel/headless.h"
 #endif
 
 #include "channel_dispatcher.h"
@@ -331,6 +332,91 @@ scpi_result_t scpi_cmd_simulatorTemperatureQ(scpi_t *context) {
     return result_float(context, value);
 }
 
+scpi_result_t scpi_cmd_simulatorCrc32TestQ(scpi_t *context) {
+    // known CRC-32 (ISO-HDLC) check values
+    static const struct {
+        const char *message;
+        uint32_t crc;
+    } vectors[] = {
+        { "", 0x00000000 },
+        { "a", 0xE8B7BE43 },
+        { "abc", 0x352441C2 },
+        { "123456789", 0xCBF43926 },
+        { "The quick brown fox jumps over the lazy dog", 0x414FA339 }
+    };
+
+    bool passed = true;
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i) {
+        const uint8_t *message = (const uint8_t *)vectors[i].message;
+        size_t size = strlen(vectors[i].message);
+
+        if (util::crc32(message, size) != vectors[i].crc) {
+            DebugTraceF("CRC32 of \"%s\" failed", vectors[i].message);
+            passed = false;
+        }
+
+        // incremental calculation must give the same result for any split
+        for (size_t split = 0; split <= size; ++split) {
+            if (util::crc32Update(util::crc32(message, split), message + split, size - split) != vectors[i].crc) {
+                DebugTraceF("CRC32 of \"%s\" split at %d failed", vectors[i].message, (int)split);
+                passed = false;
+            }
+        }
+    }
+
+    // unaligned data
+    static const char *check = "_123456789";
+    if (util::crc32((const uint8_t *)check + 1, 9) != 0xCBF43926) {
+        DebugTrace("CRC32 of unaligned data failed");
+        passed = false;
+    }
+
+    SCPI_ResultBool(context, passed);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorCrc32BenchmarkQ(scpi_t *context) {
+    int32_t size;
+    if (!SCPI_ParamInt(context, &size, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        size = SIM_CRC32_BENCHMARK_DEF_SIZE;
+    }
+
+    if (size < 1 || size > SIM_CRC32_BENCHMARK_MAX_SIZE) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    uint8_t *buffer = new uint8_t[size];
+    for (int32_t i = 0; i < size; ++i) {
+        buffer[i] = (uint8_t)(i * 31 + 7);
+    }
+
+    // repeat for at least SIM_CRC32_BENCHMARK_DURATION
+    uint32_t iterations = 0;
+    uint32_t crc = 0;
+    uint32_t start = micros();
+    uint32_t duration;
+    do {
+        crc = util::crc32Update(crc, buffer, size);
+        ++iterations;
+        duration = micros() - start;
+    } while (duration < SIM_CRC32_BENCHMARK_DURATION);
+
+    delete [] buffer;
+
+    // throughput in MB/s and time per byte in ns
+    double bytes = (double)iterations * size;
+    SCPI_ResultFloat(context, (float)(bytes / duration));
+    SCPI_ResultFloat(context, (float)(duration * 1000.0 / bytes));
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_simulatorGui(scpi_t *context) {
 #if OPTION_DISPLAY
     if (!simulator::front_panel::open()) {
@@ -345,6 +431,183 @@ scpi_result_t scpi_cmd_simulatorGui(scpi_t *context) {
 #endif
 }
 
+scpi_result_t scpi_cmd_simulatorGuiHeadless(scpi_t *context) {
+#if OPTION_DISPLAY
+    if (!simulator::front_panel::openHeadless()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiTouch(scpi_t *context) {
+#if OPTION_DISPLAY
+    int32_t x;
+    if (!SCPI_ParamInt(context, &x, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t y;
+    if (!SCPI_ParamInt(context, &y, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    simulator::front_panel::touch(true, x, y);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiTouchRelease(scpi_t *context) {
+#if OPTION_DISPLAY
+    simulator::front_panel::touch(false, -1, -1);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiEncoder(scpi_t *context) {
+#if OPTION_DISPLAY && OPTION_ENCODER
+    int32_t counter;
+    if (!SCPI_ParamInt(context, &counter, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    bool clicked = false;
+    if (!SCPI_ParamBool(context, &clicked, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+    }
+
+    simulator::front_panel::encoder(counter, clicked);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiScreenshot(scpi_t *context) {
+#if OPTION_DISPLAY
+    const char *filePath;
+    size_t filePathLength;
+    if (!SCPI_ParamCharacters(context, &filePath, &filePathLength, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    char filePathBuffer[256];
+    if (filePathLength >= sizeof(filePathBuffer)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_TOO_MUCH_DATA);
+        return SCPI_RES_ERR;
+    }
+    strncpy(filePathBuffer, filePath, filePathLength);
+    filePathBuffer[filePathLength] = 0;
+
+    if (!simulator::front_panel::saveScreenshot(filePathBuffer)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiStatisticsQ(scpi_t *context) {
+#if OPTION_DISPLAY
+    // for each page: page ID, frames, dirty frames, pixel writes,
+    // address writes, avg. and max. render time of the dirty frame in us
+    simulator::front_panel::PageFrameStatistics stats[SIM_GUI_STATISTICS_MAX_PAGES];
+    int n = simulator::front_panel::getFrameStatistics(stats, SIM_GUI_STATISTICS_MAX_PAGES);
+    if (n > SIM_GUI_STATISTICS_MAX_PAGES) {
+        n = SIM_GUI_STATISTICS_MAX_PAGES;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        SCPI_ResultInt(context, stats[i].pageId);
+        SCPI_ResultUInt32(context, stats[i].frames);
+        SCPI_ResultUInt32(context, stats[i].dirtyFrames);
+        SCPI_ResultUInt32(context, stats[i].pixelWrites);
+        SCPI_ResultUInt32(context, stats[i].addressWrites);
+        SCPI_ResultUInt32(context, stats[i].dirtyFrames > 0 ? stats[i].renderTimeTotal / stats[i].dirtyFrames : 0);
+        SCPI_ResultUInt32(context, stats[i].renderTimeMax);
+    }
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorGuiStatisticsReset(scpi_t *context) {
+#if OPTION_DISPLAY
+    simulator::front_panel::resetFrameStatistics();
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_simulatorSpiStatisticsQ(scpi_t *context) {
+    // for each chip: name, transactions, bytes, bus time in us and bus utilization in %
+    uint64_t period = simulator::chips::getSpiStatisticsPeriod();
+
+    for (int i = 0; i < simulator::chips::getNumChips(); ++i) {
+        const simulator::chips::SpiStatistics &stats = simulator::chips::getSpiStatistics(i);
+        SCPI_ResultText(context, simulator::chips::getChipName(i));
+        SCPI_ResultUInt32(context, stats.transactions);
+        SCPI_ResultUInt32(context, stats.bytes);
+        SCPI_ResultUInt32(context, (uint32_t)(stats.busTime / 1000));
+        SCPI_ResultFloat(context, period > 0 ? (float)(100.0 * stats.busTime / period) : 0.0f);
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorSpiStatisticsReset(scpi_t *context) {
+    simulator::chips::resetSpiStatistics();
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorEepromSnapshot(scpi_t *context) {
+    simulator::chips::eeprom_chip.saveSnapshot();
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorEepromRestore(scpi_t *context) {
+    // on-time record write must not land over the restored content
+    eeprom::wait_write_end();
+
+    if (!simulator::chips::eeprom_chip.restoreSnapshot()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    reloadConf();
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_simulatorExit(scpi_t *context) {
     simulator::exit();
 
@@ -425,11 +688,76 @@ scpi_result_t scpi_cmd_simulatorTemperatureQ(scpi_t *context) {
     return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorCrc32TestQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorCrc32BenchmarkQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 scpi_result_t scpi_cmd_simulatorGui(scpi_t *context) {
     SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
     return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorGuiHeadless(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiTouch(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiTouchRelease(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiEncoder(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiScreenshot(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiStatisticsQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorGuiStatisticsReset(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorSpiStatisticsQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorSpiStatisticsReset(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorEepromSnapshot(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorEepromRestore(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 scpi_result_t scpi_cmd_simulatorExit(scpi_t *context) {
     SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
     return SCPI_RES_ERR;
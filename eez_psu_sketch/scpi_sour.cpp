@@ -238,7 +238,7 @@ scpi_result_t scpi_cmd_sourceCurrentLevelImmediateStepIncrement(scpi_t * context
         return SCPI_RES_ERR;
     }
 
-    return set_step(context, &channel->i, channel->I_MIN_STEP, channel->I_MAX_STEP, channel->I_DEF_STEP, SCPI_UNIT_AMPER);
+    return set_step(context, &channel->i, channel->getParams().I_MIN_STEP, channel->getParams().I_MAX_STEP, channel->getParams().I_DEF_STEP, SCPI_UNIT_AMPER);
 }
 
 scpi_result_t scpi_cmd_sourceCurrentLevelImmediateStepIncrementQ(scpi_t * context) {
@@ -247,7 +247,7 @@ scpi_result_t scpi_cmd_sourceCurrentLevelImmediateStepIncrementQ(scpi_t * contex
         return SCPI_RES_ERR;
     }
 
-    return get_source_value(context, channel->i.step, channel->I_DEF_STEP);
+    return get_source_value(context, channel->i.step, channel->getParams().I_DEF_STEP);
 }
 
 scpi_result_t scpi_cmd_sourceVoltageLevelImmediateStepIncrement(scpi_t * context) {
@@ -256,7 +256,7 @@ scpi_result_t scpi_cmd_sourceVoltageLevelImmediateStepIncrement(scpi_t * context
         return SCPI_RES_ERR;
     }
 
-    return set_step(context, &channel->u, channel->U_MIN_STEP, channel->U_MAX_STEP, channel->U_DEF_STEP, SCPI_UNIT_VOLT);
+    return set_step(context, &channel->u, channel->getParams().U_MIN_STEP, channel->getParams().U_MAX_STEP, channel->getParams().U_DEF_STEP, SCPI_UNIT_VOLT);
 }
 
 scpi_result_t scpi_cmd_sourceVoltageLevelImmediateStepIncrementQ(scpi_t * context) {
@@ -265,7 +265,7 @@ scpi_result_t scpi_cmd_sourceVoltageLevelImmediateStepIncrementQ(scpi_t * contex
         return SCPI_RES_ERR;
     }
 
-    return get_source_value(context, channel->u.step, channel->U_DEF_STEP);
+    return get_source_value(context, channel->u.step, channel->getParams().U_DEF_STEP);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -277,7 +277,7 @@ scpi_result_t scpi_cmd_sourceCurrentProtectionDelayTime(scpi_t * context) {
     }
 
     float delay;
-    if (!get_duration_param(context, delay, channel->OCP_MIN_DELAY, channel->OCP_MAX_DELAY, channel->OCP_DEFAULT_DELAY)) {
+    if (!get_duration_param(context, delay, channel->getParams().OCP_MIN_DELAY, channel->getParams().OCP_MAX_DELAY, channel->getParams().OCP_DEFAULT_DELAY)) {
         return SCPI_RES_ERR;
     }
 
@@ -367,7 +367,7 @@ scpi_result_t scpi_cmd_sourcePowerProtectionDelayTime(scpi_t * context) {
     }
 
     float delay;
-    if (!get_duration_param(context, delay, channel->OPP_MIN_DELAY, channel->OPP_MAX_DELAY, channel->OPP_DEFAULT_DELAY)) {
+    if (!get_duration_param(context, delay, channel->getParams().OPP_MIN_DELAY, channel->getParams().OPP_MAX_DELAY, channel->getParams().OPP_DEFAULT_DELAY)) {
         return SCPI_RES_ERR;
     }
 
@@ -457,7 +457,7 @@ scpi_result_t scpi_cmd_sourceVoltageProtectionDelayTime(scpi_t * context) {
     }
 
     float delay;
-    if (!get_duration_param(context, delay, channel->OVP_MIN_DELAY, channel->OVP_MAX_DELAY, channel->OVP_DEFAULT_DELAY)) {
+    if (!get_duration_param(context, delay, channel->getParams().OVP_MIN_DELAY, channel->getParams().OVP_MAX_DELAY, channel->getParams().OVP_DEFAULT_DELAY)) {
         return SCPI_RES_ERR;
     }
 
@@ -18,6 +18,7 @@
  
 #include "psu.h"
 #include "scpi_psu.h"
+#include "channel_dispatcher.h"
 
 namespace eez {
 namespace psu {
@@ -328,6 +329,238 @@ scpi_result_t scpi_cmd_statusPreset(scpi_t * context) {
     reg_set(context, SCPI_PSU_CH_REG_QUES_INST_ISUM_ENABLE2, 0);
     reg_set(context, SCPI_PSU_CH_REG_OPER_INST_ISUM_ENABLE2, 0);
 
+    notify_reset(context);
+
+    return SCPI_RES_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool get_notify_isum_channel(scpi_t * context, int32_t &ch) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    SCPI_CommandNumbers(context, &ch, 1, psu_context->selected_channel_index);
+    if (ch < 1 || ch > MIN(CH_NUM, 2)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_HEADER_SUFFIX_OUTOFRANGE);
+        return false;
+    }
+
+    return true;
+}
+
+static bool get_notify_meas_channel(scpi_t * context, int32_t &ch) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    SCPI_CommandNumbers(context, &ch, 1, psu_context->selected_channel_index);
+    if (ch < 1 || ch > CH_NUM) {
+        SCPI_ErrorPush(context, SCPI_ERROR_HEADER_SUFFIX_OUTOFRANGE);
+        return false;
+    }
+
+    return true;
+}
+
+static bool get_notify_deadband_param(scpi_t * context, float &value, scpi_unit_t unit, float max) {
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, true)) {
+        return false;
+    }
+
+    if (param.special) {
+        if (param.tag == SCPI_NUM_MAX) {
+            value = max;
+        }
+        else if (param.tag == SCPI_NUM_MIN || param.tag == SCPI_NUM_DEF) {
+            value = 0;
+        }
+        else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return false;
+        }
+    }
+    else {
+        if (param.unit != SCPI_UNIT_NONE && param.unit != unit) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return false;
+        }
+
+        value = (float)param.value;
+        if (value < 0 || value > max) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+scpi_result_t scpi_cmd_statusNotifyOperationEnable(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t newVal;
+    if (SCPI_ParamInt32(context, &newVal, TRUE)) {
+        psu_context->notify.operEnable = (scpi_reg_val_t)newVal;
+        psu_context->notify.statusReported = false;
+        return SCPI_RES_OK;
+    }
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_statusNotifyOperationEnableQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    /* return value */
+    SCPI_ResultInt32(context, psu_context->notify.operEnable);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyQuestionableEnable(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t newVal;
+    if (SCPI_ParamInt32(context, &newVal, TRUE)) {
+        psu_context->notify.quesEnable = (scpi_reg_val_t)newVal;
+        psu_context->notify.statusReported = false;
+        return SCPI_RES_OK;
+    }
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_statusNotifyQuestionableEnableQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    /* return value */
+    SCPI_ResultInt32(context, psu_context->notify.quesEnable);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyOperationInstrumentIsummaryEnable(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_isum_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    int32_t newVal;
+    if (SCPI_ParamInt32(context, &newVal, TRUE)) {
+        psu_context->notify.operIsumEnable[ch - 1] = (scpi_reg_val_t)newVal;
+        psu_context->notify.statusReported = false;
+        return SCPI_RES_OK;
+    }
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_statusNotifyOperationInstrumentIsummaryEnableQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_isum_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    /* return value */
+    SCPI_ResultInt32(context, psu_context->notify.operIsumEnable[ch - 1]);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyQuestionableInstrumentIsummaryEnable(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_isum_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    int32_t newVal;
+    if (SCPI_ParamInt32(context, &newVal, TRUE)) {
+        psu_context->notify.quesIsumEnable[ch - 1] = (scpi_reg_val_t)newVal;
+        psu_context->notify.statusReported = false;
+        return SCPI_RES_OK;
+    }
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_statusNotifyQuestionableInstrumentIsummaryEnableQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_isum_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    /* return value */
+    SCPI_ResultInt32(context, psu_context->notify.quesIsumEnable[ch - 1]);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyMeasureVoltageDeadband(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_meas_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    float deadband;
+    if (!get_notify_deadband_param(context, deadband, SCPI_UNIT_VOLT, channel_dispatcher::getUMax(Channel::get(ch - 1)))) {
+        return SCPI_RES_ERR;
+    }
+
+    psu_context->notify.uDeadband[ch - 1] = deadband;
+    psu_context->notify.uLast[ch - 1] = NAN;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyMeasureVoltageDeadbandQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_meas_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    return result_float(context, psu_context->notify.uDeadband[ch - 1]);
+}
+
+scpi_result_t scpi_cmd_statusNotifyMeasureCurrentDeadband(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_meas_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    float deadband;
+    if (!get_notify_deadband_param(context, deadband, SCPI_UNIT_AMPER, channel_dispatcher::getIMax(Channel::get(ch - 1)))) {
+        return SCPI_RES_ERR;
+    }
+
+    psu_context->notify.iDeadband[ch - 1] = deadband;
+    psu_context->notify.iLast[ch - 1] = NAN;
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_statusNotifyMeasureCurrentDeadbandQ(scpi_t * context) {
+    scpi_psu_t *psu_context = (scpi_psu_t *)context->user_context;
+
+    int32_t ch;
+    if (!get_notify_meas_channel(context, ch)) {
+        return SCPI_RES_OK;
+    }
+
+    return result_float(context, psu_context->notify.iDeadband[ch - 1]);
+}
+
+scpi_result_t scpi_cmd_statusNotifyClear(scpi_t * context) {
+    notify_reset(context);
+
     return SCPI_RES_OK;
 }
 
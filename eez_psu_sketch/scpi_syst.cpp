@@ -345,7 +345,7 @@ scpi_result_t scpi_cmd_systemChannelInformationPowerQ(scpi_t * context) {
         return SCPI_RES_ERR;
     }
 
-    SCPI_ResultFloat(context, channel->PTOT);
+    SCPI_ResultFloat(context, channel->getParams().PTOT);
 
     return SCPI_RES_OK;
 }
@@ -708,6 +708,31 @@ scpi_result_t scpi_cmd_systemCommunicateRlstate(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_systemCommunicateLanStatusPeriod(scpi_t * context) {
+    float period;
+    if (!get_duration_param(context, period, 0, STATUS_BROADCAST_PERIOD_MAX, 0)) {
+        return SCPI_RES_ERR;
+    }
+
+    // stored in 100 ms units, any non zero period is at least 100 ms
+    uint16_t value = (uint16_t)roundf(period * 10);
+    if (value == 0 && period > 0) {
+        value = 1;
+    }
+
+    if (!persist_conf::setStatusBroadcastPeriod(value)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_systemCommunicateLanStatusPeriodQ(scpi_t * context) {
+    SCPI_ResultFloat(context, persist_conf::devConf2.statusBroadcastPeriod / 10.0f);
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_systemLocal(scpi_t * context) {
     g_rlState = RL_STATE_LOCAL;
 
@@ -41,6 +41,20 @@ static scpi_choice_def_t polarityChoice[] = {
     SCPI_CHOICE_LIST_END
 };
 
+static scpi_choice_def_t outputSourceChoice[] = {
+    { "NONE", trigger::OUTPUT_SOURCE_NONE },
+    { "TRIGger", trigger::OUTPUT_SOURCE_TRIGGER },
+    { "STEP", trigger::OUTPUT_SOURCE_STEP },
+    { "OUTPut", trigger::OUTPUT_SOURCE_OUTPUT },
+    SCPI_CHOICE_LIST_END
+};
+
+static scpi_choice_def_t stepSourceChoice[] = {
+    { "DWELl", trigger::STEP_SOURCE_DWELL },
+    { "PIN1", trigger::STEP_SOURCE_PIN1 },
+    SCPI_CHOICE_LIST_END
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 scpi_result_t scpi_cmd_triggerSequenceImmediate(scpi_t * context) {
@@ -69,6 +83,11 @@ scpi_result_t scpi_cmd_triggerSequenceDelayQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_triggerSequenceLatencyQ(scpi_t * context) {
+    SCPI_ResultFloat(context, trigger::getLatency());
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_triggerSequenceSlope(scpi_t * context) {
     int32_t polarity;
     if (!SCPI_ParamChoice(context, polarityChoice, &polarity, true)) {
@@ -101,6 +120,38 @@ scpi_result_t scpi_cmd_triggerSequenceSourceQ(scpi_t * context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_triggerSequenceStepSource(scpi_t * context) {
+    int32_t source;
+    if (!SCPI_ParamChoice(context, stepSourceChoice, &source, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    trigger::setStepSource((trigger::StepSource)source);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_triggerSequenceStepSourceQ(scpi_t * context) {
+    resultChoiceName(context, stepSourceChoice, trigger::getStepSource());
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_triggerOutputSource(scpi_t * context) {
+    int32_t source;
+    if (!SCPI_ParamChoice(context, outputSourceChoice, &source, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    trigger::setOutputSource((trigger::OutputSource)source);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_triggerOutputSourceQ(scpi_t * context) {
+    resultChoiceName(context, outputSourceChoice, trigger::getOutputSource());
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_initiate(scpi_t * context) {
     int result = trigger::initiate();
     if (result != SCPI_RES_OK) {
@@ -110,6 +110,8 @@ void tick(uint32_t tick_usec) {
         char ch = (char)Serial.read();
         input(scpi_context, ch);
     }
+
+    notify_tick(&scpi_context, tick_usec);
 }
 
 }
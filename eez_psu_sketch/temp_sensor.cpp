@@ -20,6 +20,103 @@
 #include "temp_sensor.h"
 #include "scpi_regs.h"
 
+#if defined(_VARIANT_ARDUINO_DUE_X_)
+/*
+Temperature sensors are sampled in the background: ADC is in free running mode
+converting all the sensor channels, PDC moves the conversions into one of the two
+buffers and ADC_Handler adds them, when buffer is full, to the per channel sums.
+TempSensor::read only takes the average of the samples collected since the last read.
+*/
+
+// slowest ADC clock, MCK / 512, that's still several thousand samples per second
+#define TEMP_SENSOR_ADC_PRESCAL 255
+
+// samples per channel in one PDC buffer
+#define TEMP_SENSOR_ADC_BUFFER_SAMPLES 32
+
+#define TEMP_SENSOR_ADC_NUM_CHANNELS 16
+
+static const int ADC_BUFFER_SIZE = eez::psu::temp_sensor::NUM_TEMP_SENSORS * TEMP_SENSOR_ADC_BUFFER_SAMPLES;
+
+static uint16_t g_adcBuffer[2][ADC_BUFFER_SIZE];
+static int g_adcBufferIndex;
+
+static volatile uint32_t g_adcSum[TEMP_SENSOR_ADC_NUM_CHANNELS];
+static volatile uint32_t g_adcCount[TEMP_SENSOR_ADC_NUM_CHANNELS];
+
+void ADC_Handler(void) {
+	if (ADC->ADC_ISR & ADC_ISR_ENDRX) {
+		uint16_t *buffer = g_adcBuffer[g_adcBufferIndex];
+
+		for (int i = 0; i < ADC_BUFFER_SIZE; ++i) {
+			// channel number is in the upper 4 bits (ADC_EMR_TAG)
+			uint8_t channel = buffer[i] >> 12;
+			g_adcSum[channel] += buffer[i] & 0x0FFF;
+			if (++g_adcCount[channel] == 0x80000) {
+				// nobody reads this channel, keep the average but don't overflow
+				g_adcSum[channel] >>= 1;
+				g_adcCount[channel] >>= 1;
+			}
+		}
+
+		// give the buffer back to the PDC, it's filled after the one PDC is filling now
+		ADC->ADC_RNPR = (uint32_t)buffer;
+		ADC->ADC_RNCR = ADC_BUFFER_SIZE;
+
+		g_adcBufferIndex = 1 - g_adcBufferIndex;
+	}
+}
+
+static void adc_start(uint32_t channelMask) {
+	ADC->ADC_MR = (ADC->ADC_MR & ~(ADC_MR_PRESCAL_Msk | ADC_MR_LOWRES)) | ADC_MR_FREERUN_ON | ADC_MR_PRESCAL(TEMP_SENSOR_ADC_PRESCAL);
+	ADC->ADC_EMR |= ADC_EMR_TAG;
+	ADC->ADC_CHER = channelMask;
+
+	g_adcBufferIndex = 0;
+	ADC->ADC_RPR = (uint32_t)g_adcBuffer[0];
+	ADC->ADC_RCR = ADC_BUFFER_SIZE;
+	ADC->ADC_RNPR = (uint32_t)g_adcBuffer[1];
+	ADC->ADC_RNCR = ADC_BUFFER_SIZE;
+	ADC->ADC_PTCR = ADC_PTCR_RXTEN;
+
+	ADC->ADC_IDR = 0xFFFFFFFF;
+	ADC->ADC_IER = ADC_IER_ENDRX;
+	NVIC_EnableIRQ(ADC_IRQn);
+
+	ADC->ADC_CR = ADC_CR_START;
+}
+
+/// Returns average of the samples since the last call, in the analogRead (10 bits) scale.
+static float adc_read(int pin) {
+	uint32_t channel = g_APinDescription[pin].ulADCChannelNumber;
+
+	uint32_t sum;
+	uint32_t count;
+
+	// first samples are not there yet only immediately after adc_start
+	for (int i = 0; ; ++i) {
+		noInterrupts();
+		sum = g_adcSum[channel];
+		count = g_adcCount[channel];
+		g_adcSum[channel] = 0;
+		g_adcCount[channel] = 0;
+		interrupts();
+
+		if (count > 0 || i == 100) {
+			break;
+		}
+
+		delayMicroseconds(100);
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	return sum / (4.0f * count);
+}
+#endif
+
 namespace eez {
 namespace psu {
 
@@ -38,6 +135,30 @@ TempSensor sensors[NUM_TEMP_SENSORS] = {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void init() {
+#if defined(_VARIANT_ARDUINO_DUE_X_)
+	uint32_t channelMask = 0;
+#endif
+
+	for (int i = 0; i < NUM_TEMP_SENSORS; ++i) {
+		sensors[i].init();
+
+#if defined(_VARIANT_ARDUINO_DUE_X_)
+		if (sensors[i].installed) {
+			channelMask |= 1 << g_APinDescription[sensors[i].pin].ulADCChannelNumber;
+		}
+#endif
+	}
+
+#if defined(_VARIANT_ARDUINO_DUE_X_)
+	if (channelMask) {
+		adc_start(channelMask);
+	}
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 TempSensor::TempSensor(const char *name_, int installed_, int pin_, float p1_volt_, float p1_cels_, float p2_volt_, float p2_cels_, int ch_num_, int ques_bit_, int scpi_error_)
 	: name(name_)
 	, installed(installed_)
@@ -84,7 +205,11 @@ bool TempSensor::test() {
 
 float TempSensor::read() {
 	if (installed) {
+#if defined(_VARIANT_ARDUINO_DUE_X_)
+		float value = adc_read(pin);
+#else
 		float value = (float)analogRead(pin);
+#endif
 		value = util::remap(value, (float)MIN_ADC, (float)MIN_U, (float)MAX_ADC, (float)MAX_U);
 		value = util::remap(value, p1_volt, p1_cels, p2_volt, p2_cels);
 
@@ -68,6 +68,9 @@ public:
 
 extern TempSensor sensors[NUM_TEMP_SENSORS];
 
+/// Initialize all the sensors and, on Arduino Due, start background sampling.
+void init();
+
 }
 }
 } // namespace eez::psu::temp_sensor
@@ -52,9 +52,7 @@ static uint32_t max_temp_start_tick;
 static bool force_power_down = false;
 
 void init() {
-	for (int i = 0; i < temp_sensor::NUM_TEMP_SENSORS; ++i) {
-		temp_sensor::sensors[i].init();
-	}
+	temp_sensor::init();
 }
 
 bool test() {
@@ -42,8 +42,17 @@ int touch_y = -1;
 #define sbi(reg, bitmask) *reg |= bitmask
 #define rbi(reg, bitmask) ((*reg) & bitmask)
 
-#define pulse_high(reg, bitmask) sbi(reg, bitmask); cbi(reg, bitmask);
-#define pulse_low(reg, bitmask) cbi(reg, bitmask); sbi(reg, bitmask);
+#if defined(__AVR__)
+    #define clock_delay()
+#else
+    // XPT2046 requires at least 200 ns for clock high and low time and for DOUT to settle,
+    // that is about 17 cycles at 84 MHz.
+    #define NOP5 "nop\n\tnop\n\tnop\n\tnop\n\tnop\n\t"
+    #define clock_delay() __asm__ __volatile__ (NOP5 NOP5 NOP5 NOP5)
+#endif
+
+#define pulse_high(reg, bitmask) sbi(reg, bitmask); clock_delay(); cbi(reg, bitmask); clock_delay();
+#define pulse_low(reg, bitmask) cbi(reg, bitmask); clock_delay(); sbi(reg, bitmask); clock_delay();
 
 #if defined(__AVR__)
     #define regtype volatile uint8_t
@@ -56,59 +65,37 @@ int touch_y = -1;
 regtype *P_CLK, *P_CS, *P_DIN, *P_DOUT, *P_IRQ;
 regsize B_CLK, B_CS, B_DIN, B_DOUT, B_IRQ;
 
-#if defined(__AVR__)
-    void touch_WriteData(byte data) {
-        byte temp = data;
+// Touch controller is not connected to the hardware SPI pins, so it is bit-banged,
+// but with direct port register access instead of digitalWrite/digitalRead.
+void touch_WriteData(byte data) {
+    byte temp = data;
+    cbi(P_CLK, B_CLK);
+    for (byte count = 0; count < 8; count++) {
+        if (temp & 0x80)
+            sbi(P_DIN, B_DIN);
+        else
+            cbi(P_DIN, B_DIN);
+        temp = temp << 1; 
         cbi(P_CLK, B_CLK);
-        for (byte count = 0; count < 8; count++) {
-            if (temp & 0x80)
-                sbi(P_DIN, B_DIN);
-            else
-                cbi(P_DIN, B_DIN);
-            temp = temp << 1; 
-            cbi(P_CLK, B_CLK);                
-            sbi(P_CLK, B_CLK);
-        }
+        clock_delay();
+        sbi(P_CLK, B_CLK);
+        clock_delay();
     }
+}
 
-    word touch_ReadData() {
-        word data = 0;
-        for (byte count = 0; count < 12; count++) {
-            data <<= 1;
-            sbi(P_CLK, B_CLK);
-            cbi(P_CLK, B_CLK);                
-            if (rbi(P_DOUT, B_DOUT))
-                data++;
-        }
-        return(data);
-    }
-#else
-    void touch_WriteData(byte data) {
-        byte temp = data;
+word touch_ReadData() {
+    word data = 0;
+    for (byte count = 0; count < 12; count++) {
+        data <<= 1;
+        sbi(P_CLK, B_CLK);
+        clock_delay();
         cbi(P_CLK, B_CLK);
-        for (byte count = 0; count < 8; count++) {
-            if(temp & 0x80)
-                digitalWrite(TOUCH_DIN, HIGH);
-            else
-                digitalWrite(TOUCH_DIN, LOW);
-            temp = temp << 1; 
-            digitalWrite(TOUCH_SCLK, LOW);
-            digitalWrite(TOUCH_SCLK, HIGH);
-        }
-    }
-
-    word touch_ReadData() {
-        word data = 0;
-        for (byte count = 0; count < 12; count++) {
-            data <<= 1;
-            digitalWrite(TOUCH_SCLK, HIGH);
-            digitalWrite(TOUCH_SCLK, LOW);
-            if (digitalRead(TOUCH_DOUT))
-                data++;
-        }
-        return(data);
+        clock_delay();
+        if (rbi(P_DOUT, B_DOUT))
+            data++;
     }
-#endif
+    return(data);
+}
 
 void touch_init() {
 	P_CLK	= portOutputRegister(digitalPinToPort(TOUCH_SCLK));
@@ -187,13 +174,22 @@ void touch_read() {
 void touch_init() {
 }
 
+// raw state set by the simulator, filter and transform are applied
+// to the copy taken by touch_read, just like with the real controller
+static bool sim_touch_is_pressed = false;
+static int sim_touch_x = -1;
+static int sim_touch_y = -1;
+
 void touch_read() {
+    touch_is_pressed = sim_touch_is_pressed;
+    touch_x = sim_touch_x;
+    touch_y = sim_touch_y;
 }
 
 void touch_write(bool is_pressed, int x, int y) {
-    touch_is_pressed = is_pressed;
-    touch_x = x;
-    touch_y = y;
+    sim_touch_is_pressed = is_pressed;
+    sim_touch_x = x;
+    sim_touch_y = y;
 }
 
 #endif
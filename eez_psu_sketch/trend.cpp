@@ -0,0 +1,174 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+#include "psu.h"
+#include "trend.h"
+
+namespace eez {
+namespace psu {
+namespace trend {
+
+/// Maximum channel value is mapped to this int16 value,
+/// what leaves some headroom for the overshoots.
+#define SCALE_MAX 30000
+
+void History::Accumulator::reset() {
+    uSum = 0;
+    iSum = 0;
+    count = 0;
+}
+
+void History::Accumulator::add(const Bucket &value) {
+    if (count == 0) {
+        bucket = value;
+    } else {
+        if (value.uMin < bucket.uMin) bucket.uMin = value.uMin;
+        if (value.uMax > bucket.uMax) bucket.uMax = value.uMax;
+        if (value.iMin < bucket.iMin) bucket.iMin = value.iMin;
+        if (value.iMax > bucket.iMax) bucket.iMax = value.iMax;
+    }
+
+    uSum += value.uMean;
+    iSum += value.iMean;
+    ++count;
+}
+
+void History::Accumulator::get(Bucket &result) {
+    result = bucket;
+    result.uMean = (int16_t)(uSum / count);
+    result.iMean = (int16_t)(iSum / count);
+}
+
+void History::init(float uMax, float iMax) {
+    uScale = uMax / SCALE_MAX;
+    iScale = iMax / SCALE_MAX;
+
+    lastTick = micros();
+    numSeconds = 0;
+
+    resetSamples();
+
+    secondAccumulator.reset();
+    minuteAccumulator.reset();
+
+    for (int tier = 0; tier < NUM_TIERS; ++tier) {
+        position[tier] = 0;
+        count[tier] = 0;
+    }
+}
+
+int16_t History::encode(float value, float scale) {
+    float result = roundf(value / scale);
+    if (result < -32767) return -32767;
+    if (result > 32767) return 32767;
+    return (int16_t)result;
+}
+
+void History::addBucket(Tier tier, const Bucket &bucket) {
+    Bucket *buckets = tier == TIER_SECONDS ? seconds : minutes;
+    uint16_t size = tier == TIER_SECONDS ? TREND_SECONDS_SIZE : TREND_MINUTES_SIZE;
+
+    buckets[position[tier]] = bucket;
+    if (++position[tier] == size) {
+        position[tier] = 0;
+    }
+    if (count[tier] < size) {
+        ++count[tier];
+    }
+}
+
+void History::resetSamples() {
+    samplePosition = -1;
+}
+
+void History::tick(uint32_t tick_usec, float u, float i, float sampleRate) {
+    Bucket sample;
+    sample.uMin = sample.uMax = sample.uMean = encode(u, uScale);
+    sample.iMin = sample.iMax = sample.iMean = encode(i, iScale);
+
+    if (samplePosition == -1) {
+        samples[0].u = sample.uMean;
+        samples[0].i = sample.iMean;
+        for (int k = 1; k < CHANNEL_HISTORY_SIZE; ++k) {
+            samples[k].u = 0;
+            samples[k].i = 0;
+        }
+
+        samplePosition = 1;
+        lastSampleTick = tick_usec;
+    } else {
+        uint32_t samplePeriod = (uint32_t)round(sampleRate * 1000000L);
+
+        while (tick_usec - lastSampleTick >= samplePeriod) {
+            samples[samplePosition].u = sample.uMean;
+            samples[samplePosition].i = sample.iMean;
+
+            if (++samplePosition == CHANNEL_HISTORY_SIZE) {
+                samplePosition = 0;
+            }
+
+            lastSampleTick += samplePeriod;
+        }
+    }
+
+    while (tick_usec - lastTick >= 1000000L) {
+        if (secondAccumulator.count == 0) {
+            // tick was late for more then one second,
+            // use the last sample for all the missed seconds
+            secondAccumulator.add(sample);
+        }
+
+        Bucket bucket;
+        secondAccumulator.get(bucket);
+        addBucket(TIER_SECONDS, bucket);
+
+        minuteAccumulator.add(bucket);
+        if (++numSeconds == 60) {
+            minuteAccumulator.get(bucket);
+            addBucket(TIER_MINUTES, bucket);
+
+            minuteAccumulator.reset();
+            numSeconds = 0;
+        }
+
+        secondAccumulator.reset();
+
+        lastTick += 1000000L;
+    }
+
+    secondAccumulator.add(sample);
+}
+
+int History::getNumBuckets(Tier tier) {
+    return count[tier];
+}
+
+const Bucket &History::getBucket(Tier tier, int index) {
+    Bucket *buckets = tier == TIER_SECONDS ? seconds : minutes;
+    int size = tier == TIER_SECONDS ? TREND_SECONDS_SIZE : TREND_MINUTES_SIZE;
+
+    index += position[tier] - count[tier];
+    if (index < 0) {
+        index += size;
+    }
+    return buckets[index];
+}
+
+}
+}
+} // namespace eez::psu::trend
@@ -0,0 +1,111 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace trend {
+
+/// Resolution of the trend buckets.
+enum Tier {
+    TIER_SECONDS,
+    TIER_MINUTES,
+    NUM_TIERS
+};
+
+/// Minimum, maximum and mean of the measured voltage and current during one bucket period.
+/// Values are stored as int16 scaled to the channel maximum (see History::decodeU and History::decodeI).
+struct Bucket {
+    int16_t uMin;
+    int16_t uMax;
+    int16_t uMean;
+    int16_t iMin;
+    int16_t iMax;
+    int16_t iMean;
+};
+
+/// Voltage and current sample, scaled the same way as the bucket values.
+struct Sample {
+    int16_t u;
+    int16_t i;
+};
+
+/// Multi-resolution history of the channel measurements.
+/// Samples for the YT view are taken at the YT view rate into the ring of
+/// CHANNEL_HISTORY_SIZE samples. Every second one bucket is added to the
+/// TIER_SECONDS and every minute one bucket (calculated from the last 60
+/// seconds buckets) is added to the TIER_MINUTES.
+class History {
+public:
+    void init(float uMax, float iMax);
+    void tick(uint32_t tick_usec, float u, float i, float sampleRate);
+
+    /// Restarts the YT view samples, all samples except the first one are cleared.
+    void resetSamples();
+    /// Position in the samples ring where the next sample will be stored.
+    int getSamplePosition() { return samplePosition; }
+    float getSampleU(int position) const { return decodeU(samples[position].u); }
+    float getSampleI(int position) const { return decodeI(samples[position].i); }
+
+    /// Number of the available buckets in the tier.
+    int getNumBuckets(Tier tier);
+    /// Returns bucket from the tier, index 0 is the oldest available bucket.
+    const Bucket &getBucket(Tier tier, int index);
+
+    float decodeU(int16_t value) const { return value * uScale; }
+    float decodeI(int16_t value) const { return value * iScale; }
+
+private:
+    struct Accumulator {
+        // tick rate is not limited, so there can be more then 64K samples per second
+        int64_t uSum;
+        int64_t iSum;
+        uint32_t count;
+        Bucket bucket;
+
+        void reset();
+        void add(const Bucket &value);
+        void get(Bucket &result);
+    };
+
+    float uScale;
+    float iScale;
+
+    uint32_t lastTick;
+    uint8_t numSeconds;
+
+    Sample samples[CHANNEL_HISTORY_SIZE];
+    int samplePosition;
+    uint32_t lastSampleTick;
+
+    Accumulator secondAccumulator;
+    Accumulator minuteAccumulator;
+
+    Bucket seconds[TREND_SECONDS_SIZE];
+    Bucket minutes[TREND_MINUTES_SIZE];
+    uint16_t position[NUM_TIERS];
+    uint16_t count[NUM_TIERS];
+
+    int16_t encode(float value, float scale);
+    void addBucket(Tier tier, const Bucket &bucket);
+};
+
+}
+}
+} // namespace eez::psu::trend
@@ -32,8 +32,11 @@ static struct {
 } g_levels[CH_MAX];
 
 static float g_delay;
+static uint32_t g_delayUsec;
 static Source g_source;
 static Polarity g_polarity;
+static OutputSource g_outputSource;
+static StepSource g_stepSource;
 
 enum State {
     STATE_IDLE,
@@ -41,19 +44,33 @@ enum State {
     STATE_TRIGGERED,
     STATE_EXECUTING
 };
-static State g_state;
+static volatile State g_state;
 static bool g_continuousInitializationEnabled;
-static uint32_t g_triggeredTime;
-static uint8_t g_extTrigLastState;
+static volatile uint32_t g_triggeredTime;
+static uint32_t g_latency;
 
 static const int VOLTAGE_TRIGGER_IN_PROGRESS = 1;
 static const int CURRENT_TRIGGER_IN_PROGRESS = 2;
 uint8_t g_triggerInProgress[CH_NUM];
 
+void extTrigInterruptHandler() {
+    if (g_stepSource == STEP_SOURCE_PIN1 && g_state == STATE_EXECUTING) {
+        list::step();
+    } else {
+        generateTrigger(SOURCE_PIN1, false);
+    }
+}
+
+static void attachExtTrigInterrupt() {
+    attachInterrupt(digitalPinToInterrupt(EXT_TRIG), extTrigInterruptHandler, g_polarity == POLARITY_POSITIVE ? RISING : FALLING);
+}
+
 void reset() {
-    g_delay = DELAY_DEFAULT;
+    setDelay(DELAY_DEFAULT);
     g_source = SOURCE_IMMEDIATE;
-    g_polarity = POLARITY_POSITIVE;
+    setPolarity(POLARITY_POSITIVE);
+    setOutputSource(OUTPUT_SOURCE_NONE);
+    g_stepSource = STEP_SOURCE_DWELL;
 
     for (int i = 0; i < CH_NUM; ++i) {
         g_levels[i].u = 0;
@@ -62,27 +79,16 @@ void reset() {
 
     g_state = STATE_IDLE;
     g_continuousInitializationEnabled = false;
-}
-
-void extTrigInterruptHandler() {
-    uint8_t state = digitalRead(EXT_TRIG);
-    if (state == 1 && g_extTrigLastState == 0 && g_polarity == POLARITY_POSITIVE || state == 0 && g_extTrigLastState == 1 && g_polarity == POLARITY_NEGATIVE) {
-        generateTrigger(SOURCE_PIN1, false);
-    }
-    g_extTrigLastState = state;
+    g_latency = 0;
 }
 
 void init() {
     reset();
-
-    noInterrupts();
-    g_extTrigLastState = digitalRead(EXT_TRIG);
-    attachInterrupt(digitalPinToInterrupt(EXT_TRIG), extTrigInterruptHandler, CHANGE);
-    interrupts();
 }
 
 void setDelay(float delay) {
     g_delay = delay;
+    g_delayUsec = (uint32_t)(delay * 1000000.0f);
 }
 
 float getDelay() {
@@ -99,12 +105,46 @@ Source getSource() {
 
 void setPolarity(Polarity polarity) {
     g_polarity = polarity;
+    attachExtTrigInterrupt();
 }
 
 Polarity getPolarity() {
     return g_polarity;
 }
 
+void setOutputSource(OutputSource source) {
+    g_outputSource = source;
+
+#if (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12) && !defined(EEZ_PSU_SIMULATOR) && !OPTION_SYNC_MASTER
+    // with the sync clock enabled, psu::tick takes the pin over from the clock
+    pinMode(SYNC_MASTER, source == OUTPUT_SOURCE_NONE ? INPUT : OUTPUT);
+#endif
+}
+
+OutputSource getOutputSource() {
+    return g_outputSource;
+}
+
+void outputPulse(OutputSource source) {
+    if (g_outputSource != source) {
+        return;
+    }
+
+#if (EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R3B4 || EEZ_PSU_SELECTED_REVISION == EEZ_PSU_REVISION_R5B12) && !defined(EEZ_PSU_SIMULATOR)
+    digitalWrite(SYNC_MASTER, HIGH);
+    delayMicroseconds(TRIGGER_OUTPUT_PULSE_WIDTH_US);
+    digitalWrite(SYNC_MASTER, LOW);
+#endif
+}
+
+void setStepSource(StepSource source) {
+    g_stepSource = source;
+}
+
+StepSource getStepSource() {
+    return g_stepSource;
+}
+
 void setVoltage(Channel &channel, float value) {
     g_levels[channel.index - 1].u = value;
 }
@@ -121,13 +161,33 @@ float getCurrent(Channel &channel) {
     return g_levels[channel.index - 1].i;
 }
 
-void check(uint32_t currentTime) {
-    if (currentTime - g_triggeredTime > g_delay * 1000L) {
-        startImmediately();
+float getLatency() {
+    return g_latency / 1000000.0f;
+}
+
+static void check() {
+    uint32_t elapsed = micros() - g_triggeredTime;
+    if (elapsed < g_delayUsec) {
+        if (g_delayUsec - elapsed > TRIGGER_DELAY_SPIN_TIME_US) {
+            return;
+        }
+
+        // main loop may not come back in time, wait here for the rest of the delay
+        while (micros() - g_triggeredTime < g_delayUsec) {
+        }
     }
+
+    startImmediately();
+
+    g_latency = micros() - g_triggeredTime;
+
+    outputPulse(OUTPUT_SOURCE_TRIGGER);
 }
 
 int generateTrigger(Source source, bool checkImmediatelly) {
+    // timestamp first, this can be called from the EXT_TRIG interrupt
+    uint32_t triggeredTime = micros();
+
     if (g_source != source) {
         return SCPI_ERROR_TRIGGER_IGNORED;
     }
@@ -136,12 +196,11 @@ int generateTrigger(Source source, bool checkImmediatelly) {
         return SCPI_ERROR_TRIGGER_IGNORED;
     }
 
+    g_triggeredTime = triggeredTime;
     g_state = STATE_TRIGGERED;
 
-    g_triggeredTime = micros() / 1000;
-
     if (checkImmediatelly) {
-        check(g_triggeredTime);
+        check();
     }
 
     return SCPI_RES_OK;
@@ -312,7 +371,7 @@ void abort() {
 
 void tick(uint32_t tick_usec) {
     if (g_state == STATE_TRIGGERED) {
-        check(tick_usec / 1000);
+        check();
     }
 }
 
@@ -38,6 +38,21 @@ enum Polarity {
     POLARITY_NEGATIVE = 0
 };
 
+/// Event that emits a pulse on the SYNC pin. With OUTPUT_SOURCE_NONE
+/// the pin carries the sync clock instead.
+enum OutputSource {
+    OUTPUT_SOURCE_NONE,
+    OUTPUT_SOURCE_TRIGGER,
+    OUTPUT_SOURCE_STEP,
+    OUTPUT_SOURCE_OUTPUT
+};
+
+/// What advances the list to the next point once the trigger is executed.
+enum StepSource {
+    STEP_SOURCE_DWELL,
+    STEP_SOURCE_PIN1
+};
+
 void init();
 void reset();
 
@@ -50,6 +65,19 @@ Source getSource();
 void setPolarity(Polarity polarity);
 Polarity getPolarity();
 
+void setOutputSource(OutputSource source);
+OutputSource getOutputSource();
+
+/// Emits a pulse on the SYNC pin if the output source is set to the given event.
+void outputPulse(OutputSource source);
+
+void setStepSource(StepSource source);
+StepSource getStepSource();
+
+/// Time, in seconds, from the last trigger until its levels were applied,
+/// including the trigger delay.
+float getLatency();
+
 void setVoltage(Channel &channel, float value);
 float getVoltage(Channel &channel);
 
@@ -46,6 +46,9 @@ void strcatDuration(char *str, float value);
 void strcatLoad(char *str, float value);
 
 uint32_t crc32(const uint8_t *message, size_t size);
+/// Continues CRC32 calculation with more data, crc32Update(crc32(a), b) gives
+/// the same result as crc32 of a and b concatenated. Initial crc value is 0.
+uint32_t crc32Update(uint32_t crc, const uint8_t *message, size_t size);
 
 uint8_t toBCD(uint8_t bin);
 uint8_t fromBCD(uint8_t bcd);
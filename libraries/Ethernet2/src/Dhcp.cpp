@@ -92,23 +92,8 @@ int DhcpClass::request_DHCP_lease(){
             messageType = parseDHCPResponse(_responseTimeout, respId);
             if(messageType == DHCP_ACK)
             {
-                _dhcp_state = STATE_DHCP_LEASED;
                 result = 1;
-                //use default lease time if we didn't get it
-                if(_dhcpLeaseTime == 0){
-                    _dhcpLeaseTime = DEFAULT_LEASE;
-                }
-                //calculate T1 & T2 if we didn't get it
-                if(_dhcpT1 == 0){
-                    //T1 should be 50% of _dhcpLeaseTime
-                    _dhcpT1 = _dhcpLeaseTime >> 1;
-                }
-                if(_dhcpT2 == 0){
-                    //T2 should be 87.5% (7/8ths) of _dhcpLeaseTime
-                    _dhcpT2 = _dhcpT1 << 1;
-                }
-                _renewInSec = _dhcpT1;
-                _rebindInSec = _dhcpT2;
+                set_DHCP_leased();
             }
             else if(messageType == DHCP_NAK)
                 _dhcp_state = STATE_DHCP_START;
@@ -131,6 +116,116 @@ int DhcpClass::request_DHCP_lease(){
     return result;
 }
 
+void DhcpClass::set_DHCP_leased()
+{
+    _dhcp_state = STATE_DHCP_LEASED;
+    //use default lease time if we didn't get it
+    if(_dhcpLeaseTime == 0){
+        _dhcpLeaseTime = DEFAULT_LEASE;
+    }
+    //calculate T1 & T2 if we didn't get it
+    if(_dhcpT1 == 0){
+        //T1 should be 50% of _dhcpLeaseTime
+        _dhcpT1 = _dhcpLeaseTime >> 1;
+    }
+    if(_dhcpT2 == 0){
+        //T2 should be 87.5% (7/8ths) of _dhcpLeaseTime
+        _dhcpT2 = _dhcpT1 << 1;
+    }
+    _renewInSec = _dhcpT1;
+    _rebindInSec = _dhcpT2;
+}
+
+//return:0 if socket couldn't be opened, 1 if DISCOVER will be sent by pollDHCP
+int DhcpClass::beginWithDHCPAsync(uint8_t *mac, unsigned long timeout, unsigned long responseTimeout)
+{
+    _dhcpLeaseTime=0;
+    _dhcpT1=0;
+    _dhcpT2=0;
+    _lastCheck=0;
+    _timeout = timeout;
+    _responseTimeout = responseTimeout;
+
+    memset(_dhcpMacAddr, 0, 6);
+    reset_DHCP_lease();
+
+    memcpy((void*)_dhcpMacAddr, (void*)mac, 6);
+    _dhcp_state = STATE_DHCP_START;
+
+    _dhcpTransactionId = random(1UL, 2000UL);
+    _dhcpInitialTransactionId = _dhcpTransactionId;
+
+    _dhcpUdpSocket.stop();
+    if (_dhcpUdpSocket.begin(DHCP_CLIENT_PORT) == 0)
+    {
+      return 0;
+    }
+
+    presend_DHCP();
+
+    _asyncStartTime = millis();
+
+    return 1;
+}
+
+// Same state machine as request_DHCP_lease, but it never waits for the
+// server: each call sends a message or handles at most one received packet.
+int DhcpClass::pollDHCP()
+{
+    unsigned long now = millis();
+
+    if(_dhcp_state == STATE_DHCP_START)
+    {
+        _dhcpTransactionId++;
+        send_DHCP_MESSAGE(DHCP_DISCOVER, ((now - _asyncStartTime) / 1000));
+        _dhcp_state = STATE_DHCP_DISCOVER;
+        _asyncResponseTime = now;
+    }
+    else if(_dhcp_state == STATE_DHCP_DISCOVER || _dhcp_state == STATE_DHCP_REQUEST)
+    {
+        if(_dhcpUdpSocket.parsePacket() > 0)
+        {
+            uint32_t respId;
+            uint8_t messageType = parseDHCPPacket(respId);
+            if(_dhcp_state == STATE_DHCP_DISCOVER && messageType == DHCP_OFFER)
+            {
+                _dhcpTransactionId = respId;
+                send_DHCP_MESSAGE(DHCP_REQUEST, ((now - _asyncStartTime) / 1000));
+                _dhcp_state = STATE_DHCP_REQUEST;
+                _asyncResponseTime = now;
+            }
+            else if(_dhcp_state == STATE_DHCP_REQUEST && messageType == DHCP_ACK)
+            {
+                set_DHCP_leased();
+            }
+            else if(_dhcp_state == STATE_DHCP_REQUEST && messageType == DHCP_NAK)
+            {
+                _dhcp_state = STATE_DHCP_START;
+            }
+        }
+        else if((now - _asyncResponseTime) > _responseTimeout)
+        {
+            _dhcp_state = STATE_DHCP_START;
+        }
+    }
+
+    if(_dhcp_state == STATE_DHCP_LEASED)
+    {
+        _dhcpUdpSocket.stop();
+        _dhcpTransactionId++;
+        return DHCP_ASYNC_LEASED;
+    }
+
+    if((now - _asyncStartTime) > _timeout)
+    {
+        _dhcpUdpSocket.stop();
+        _dhcpTransactionId++;
+        return DHCP_ASYNC_FAILED;
+    }
+
+    return DHCP_ASYNC_PENDING;
+}
+
 void DhcpClass::presend_DHCP()
 {
 }
@@ -255,13 +350,8 @@ void DhcpClass::send_DHCP_MESSAGE(uint8_t messageType, uint16_t secondsElapsed)
 
 uint8_t DhcpClass::parseDHCPResponse(unsigned long responseTimeout, uint32_t& transactionId)
 {
-    uint8_t type = 0;
-    uint8_t opt_len = 0;
-	
     unsigned long startTime = millis();
-    
-	
-	
+
     while(_dhcpUdpSocket.parsePacket() <= 0)
     {
         if((millis() - startTime) > responseTimeout)
@@ -271,7 +361,15 @@ uint8_t DhcpClass::parseDHCPResponse(unsigned long responseTimeout, uint32_t& tr
         }
         delay(50);
     }
-	
+
+    return parseDHCPPacket(transactionId);
+}
+
+uint8_t DhcpClass::parseDHCPPacket(uint32_t& transactionId)
+{
+    uint8_t type = 0;
+    uint8_t opt_len = 0;
+
     // start reading in the packet
     RIP_MSG_FIXED fixedMsg;
     _dhcpUdpSocket.read((uint8_t*)&fixedMsg, sizeof(RIP_MSG_FIXED));
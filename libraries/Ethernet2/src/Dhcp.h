@@ -53,6 +53,10 @@
 #define DHCP_CHECK_REBIND_FAIL  (3)
 #define DHCP_CHECK_REBIND_OK    (4)
 
+#define DHCP_ASYNC_PENDING      (0)
+#define DHCP_ASYNC_LEASED       (1)
+#define DHCP_ASYNC_FAILED       (2)
+
 enum
 {
 	padOption		=	0,
@@ -155,15 +159,19 @@ private:
   unsigned long _timeout;
   unsigned long _responseTimeout;
   unsigned long _secTimeout;
+  unsigned long _asyncStartTime;
+  unsigned long _asyncResponseTime;
   uint8_t _dhcp_state;
   EthernetUDP _dhcpUdpSocket;
   int request_DHCP_lease();
   void reset_DHCP_lease();
+  void set_DHCP_leased();
   void presend_DHCP();
   void send_DHCP_MESSAGE(uint8_t, uint16_t);
   void printByte(char *, uint8_t);
   
   uint8_t parseDHCPResponse(unsigned long responseTimeout, uint32_t& transactionId);
+  uint8_t parseDHCPPacket(uint32_t& transactionId);
 public:
   IPAddress getLocalIp();
   IPAddress getSubnetMask();
@@ -173,6 +181,11 @@ public:
   
   int beginWithDHCP(uint8_t *, unsigned long timeout = 60000, unsigned long responseTimeout = 5000);  
   int checkLease();
+
+  // Non-blocking variant of beginWithDHCP, call pollDHCP until it returns
+  // DHCP_ASYNC_LEASED or DHCP_ASYNC_FAILED
+  int beginWithDHCPAsync(uint8_t *, unsigned long timeout = 60000, unsigned long responseTimeout = 5000);
+  int pollDHCP();
 };
 
 #endif
@@ -99,6 +99,33 @@ int EthernetClass::begin(uint8_t *mac_address)
   return ret;
 }
 
+int EthernetClass::beginAsync(uint8_t *mac_address)
+{
+  if (_dhcp == NULL) {
+    _dhcp = new DhcpClass();
+  }
+  // Initialise the basic info
+  w5500.init(w5500_cspin);
+  w5500.setMACAddress(mac_address);
+  w5500.setIPAddress(IPAddress(0,0,0,0).raw_address());
+
+  return _dhcp->beginWithDHCPAsync(mac_address, _dhcpTimeout);
+}
+
+int EthernetClass::pollAsync()
+{
+  int ret = _dhcp->pollDHCP();
+  if(ret == DHCP_ASYNC_LEASED)
+  {
+    w5500.setIPAddress(_dhcp->getLocalIp().raw_address());
+    w5500.setGatewayIp(_dhcp->getGatewayIp().raw_address());
+    w5500.setSubnetMask(_dhcp->getSubnetMask().raw_address());
+    _dnsServerAddress = _dhcp->getDnsServerIp();
+  }
+
+  return ret;
+}
+
 void EthernetClass::begin(uint8_t *mac_address, IPAddress local_ip)
 {
   // Assume the DNS server will be the machine on the same network as the local IP
@@ -30,7 +30,7 @@ public:
   static uint8_t _state[MAX_SOCK_NUM];
   static uint16_t _server_port[MAX_SOCK_NUM];
 
-  EthernetClass() { w5500_cspin = 10; _dhcpTimeout = 60000; }
+  EthernetClass() { w5500_cspin = 10; _dhcpTimeout = 60000; _dhcp = NULL; }
   void init(uint8_t _cspin = 10) { w5500_cspin = _cspin; }
 
   void setDhcpTimeout(unsigned long timeout) {
@@ -52,6 +52,10 @@ public:
   // configuration through DHCP.
   // Returns 0 if the DHCP configuration failed, and 1 if it succeeded
   int begin(uint8_t *mac_address);
+  // Same as begin(mac_address) but DHCP runs in the background: call
+  // pollAsync until it returns DHCP_ASYNC_LEASED or DHCP_ASYNC_FAILED
+  int beginAsync(uint8_t *mac_address);
+  int pollAsync();
   void begin(uint8_t *mac_address, IPAddress local_ip);
   void begin(uint8_t *mac_address, IPAddress local_ip, IPAddress dns_server);
   void begin(uint8_t *mac_address, IPAddress local_ip, IPAddress dns_server, IPAddress gateway);
@@ -318,6 +318,36 @@ void SCPI_Init(scpi_t * context,
 #endif
 }
 
+/**
+ * Search command line termination in the data added to system buffer
+ * and call command parser for every complete command line.
+ *
+ * @param context
+ * @return
+ */
+static scpi_bool_t processInput(scpi_t * context) {
+    scpi_bool_t result = TRUE;
+    size_t totcmdlen = 0;
+    int cmdlen = 0;
+
+    while (1) {
+        cmdlen = scpiParser_detectProgramMessageUnit(&context->parser_state, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
+        totcmdlen += cmdlen;
+
+        if (context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NL) {
+            result = SCPI_Parse(context, context->buffer.data, totcmdlen);
+            memmove(context->buffer.data, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
+            context->buffer.position -= totcmdlen;
+            totcmdlen = 0;
+        } else {
+            if (context->parser_state.programHeader.type == SCPI_TOKEN_UNKNOWN) break;
+            if (totcmdlen >= context->buffer.position) break;
+        }
+    }
+
+    return result;
+}
+
 /**
  * Interface to the application. Adds data to system buffer and try to search
  * command line termination. If the termination is found or if len=0, command
@@ -330,8 +360,6 @@ void SCPI_Init(scpi_t * context,
  */
 scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len) {
     scpi_bool_t result = TRUE;
-    size_t totcmdlen = 0;
-    int cmdlen = 0;
 
     if (len == 0) {
         context->buffer.data[context->buffer.position] = 0;
@@ -352,26 +380,42 @@ scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len) {
         context->buffer.position += len;
         context->buffer.data[context->buffer.position] = 0;
 
-
-        while (1) {
-            cmdlen = scpiParser_detectProgramMessageUnit(&context->parser_state, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-            totcmdlen += cmdlen;
-
-            if (context->parser_state.termination == SCPI_MESSAGE_TERMINATION_NL) {
-                result = SCPI_Parse(context, context->buffer.data, totcmdlen);
-                memmove(context->buffer.data, context->buffer.data + totcmdlen, context->buffer.position - totcmdlen);
-                context->buffer.position -= totcmdlen;
-                totcmdlen = 0;
-            } else {
-                if (context->parser_state.programHeader.type == SCPI_TOKEN_UNKNOWN) break;
-                if (totcmdlen >= context->buffer.position) break;
-            }
-        }
+        result = processInput(context);
     }
 
     return result;
 }
 
+/**
+ * Interface to the application. Returns free part of the system buffer,
+ * so application can receive data directly into it and then call
+ * SCPI_InputCommit, instead of copying data with SCPI_Input.
+ *
+ * @param context
+ * @param len - returns how many bytes can be stored in the returned buffer
+ * @return
+ */
+char * SCPI_InputBuffer(scpi_t * context, int * len) {
+    /* one byte is reserved for the terminating zero */
+    *len = context->buffer.length - context->buffer.position - 1;
+    return &context->buffer.data[context->buffer.position];
+}
+
+/**
+ * Interface to the application. Process len bytes stored by the application
+ * into the buffer returned by SCPI_InputBuffer, same as SCPI_Input does.
+ *
+ * @param context
+ * @param len - length of data stored, must be > 0
+ * @return
+ */
+scpi_bool_t SCPI_InputCommit(scpi_t * context, int len) {
+    context->buffer.position += len;
+    context->buffer.data[context->buffer.position] = 0;
+
+    return processInput(context);
+}
+
 /* writing results */
 
 /**
@@ -52,6 +52,8 @@ extern "C" {
             int16_t * error_queue_data, int16_t error_queue_size);
 
     scpi_bool_t SCPI_Input(scpi_t * context, const char * data, int len);
+    char * SCPI_InputBuffer(scpi_t * context, int * len);
+    scpi_bool_t SCPI_InputCommit(scpi_t * context, int len);
     scpi_bool_t SCPI_Parse(scpi_t * context, char * data, int len);
 
     size_t SCPI_ResultCharacters(scpi_t * context, const char * data, size_t len);
@@ -32,6 +32,7 @@ namespace ethernet_platform {
 
 static int listen_socket = -1;
 static int client_socket = -1;
+static int udp_socket = -1;
 
 bool enable_non_blocking(int fd) {
     int flags = fcntl(fd, F_GETFL, 0);
@@ -172,6 +173,79 @@ void stop() {
     client_socket = -1;
 }
 
+
+bool udp_bind(int port) {
+    sockaddr_in serv_addr;
+    udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_socket < 0) {
+        DebugTraceF("EHTERNET: UDP socket failed with error %d", errno);
+        return false;
+    }
+
+    if (!enable_non_blocking(udp_socket)) {
+        DebugTraceF("EHTERNET: ioctl on UDP socket failed with error %d", errno);
+        close(udp_socket);
+        udp_socket = -1;
+        return false;
+    }
+
+    int broadcast = 1;
+    if (setsockopt(udp_socket, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast)) < 0) {
+        DebugTraceF("EHTERNET: setsockopt on UDP socket failed with error %d", errno);
+        close(udp_socket);
+        udp_socket = -1;
+        return false;
+    }
+
+    bzero((char *)&serv_addr, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = INADDR_ANY;
+    serv_addr.sin_port = htons(port);
+    if (::bind(udp_socket, (sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        DebugTraceF("EHTERNET: UDP bind failed with error %d", errno);
+        close(udp_socket);
+        udp_socket = -1;
+        return false;
+    }
+
+    return true;
+}
+
+int udp_recv(char *buffer, int buffer_size, uint32_t &remote_ip, uint16_t &remote_port) {
+    if (udp_socket == -1) return 0;
+
+    sockaddr_in cli_addr;
+    socklen_t clilen = sizeof(cli_addr);
+    int n = ::recvfrom(udp_socket, buffer, buffer_size, 0, (sockaddr *)&cli_addr, &clilen);
+    if (n < 0) {
+        if (errno != EWOULDBLOCK) {
+            DebugTraceF("EHTERNET: UDP recvfrom failed with error %d", errno);
+        }
+        return 0;
+    }
+
+    remote_ip = cli_addr.sin_addr.s_addr;
+    remote_port = ntohs(cli_addr.sin_port);
+    return n;
+}
+
+int udp_send(uint32_t ip, uint16_t port, const char *buffer, int buffer_size) {
+    if (udp_socket == -1) return 0;
+
+    sockaddr_in dest_addr;
+    bzero((char *)&dest_addr, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_addr.s_addr = ip;
+    dest_addr.sin_port = htons(port);
+    int n = ::sendto(udp_socket, buffer, buffer_size, 0, (sockaddr *)&dest_addr, sizeof(dest_addr));
+    if (n < 0) {
+        DebugTraceF("EHTERNET: UDP sendto failed with error %d", errno);
+        return 0;
+    }
+
+    return n;
+}
+
 }
 }
 } // namespace eez::psu::ethernet_platform
@@ -19,6 +19,7 @@
 #include "psu.h"
 #include "serial_psu.h"
 #include "main_loop.h"
+#include "scpi_trace.h"
 
 #include <errno.h>
 #include "thread_queue.h"
@@ -61,6 +62,7 @@ int main_loop() {
             switch (msg.msgtype) {
             case NEW_INPUT_MESSAGE:
                 p_ch = (char *)msg.data;
+                simulator::scpi_trace::onInput(simulator::scpi_trace::SOURCE_SERIAL, *p_ch);
                 scpi::input(serial::scpi_context, *p_ch);
                 delete p_ch;
                 break;
@@ -39,6 +39,7 @@ namespace ethernet_platform {
 
 static SOCKET listen_socket = INVALID_SOCKET;
 static SOCKET client_socket = INVALID_SOCKET;
+static SOCKET udp_socket = INVALID_SOCKET;
 
 bool bind(int port) {
     WSADATA wsaData;
@@ -199,6 +200,83 @@ void stop() {
     }
 }
 
+
+bool udp_bind(int port) {
+    udp_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (udp_socket == INVALID_SOCKET) {
+        DebugTraceF("EHTERNET: UDP socket failed with error %ld\n", WSAGetLastError());
+        return false;
+    }
+
+    u_long iMode = 1;
+    int iResult = ioctlsocket(udp_socket, FIONBIO, &iMode);
+    if (iResult != NO_ERROR) {
+        DebugTraceF("EHTERNET: UDP ioctlsocket failed with error %ld\n", iResult);
+        closesocket(udp_socket);
+        udp_socket = INVALID_SOCKET;
+        return false;
+    }
+
+    BOOL broadcast = TRUE;
+    iResult = setsockopt(udp_socket, SOL_SOCKET, SO_BROADCAST, (const char *)&broadcast, sizeof(broadcast));
+    if (iResult == SOCKET_ERROR) {
+        DebugTraceF("EHTERNET: UDP setsockopt failed with error %d\n", WSAGetLastError());
+        closesocket(udp_socket);
+        udp_socket = INVALID_SOCKET;
+        return false;
+    }
+
+    sockaddr_in serv_addr;
+    ZeroMemory(&serv_addr, sizeof(serv_addr));
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = INADDR_ANY;
+    serv_addr.sin_port = htons(port);
+    iResult = ::bind(udp_socket, (sockaddr *)&serv_addr, sizeof(serv_addr));
+    if (iResult == SOCKET_ERROR) {
+        DebugTraceF("EHTERNET: UDP bind failed with error %d\n", WSAGetLastError());
+        closesocket(udp_socket);
+        udp_socket = INVALID_SOCKET;
+        return false;
+    }
+
+    return true;
+}
+
+int udp_recv(char *buffer, int buffer_size, uint32_t &remote_ip, uint16_t &remote_port) {
+    if (udp_socket == INVALID_SOCKET) return 0;
+
+    sockaddr_in cli_addr;
+    int clilen = sizeof(cli_addr);
+    int iResult = ::recvfrom(udp_socket, buffer, buffer_size, 0, (sockaddr *)&cli_addr, &clilen);
+    if (iResult == SOCKET_ERROR) {
+        if (WSAGetLastError() != WSAEWOULDBLOCK) {
+            DebugTraceF("EHTERNET: UDP recvfrom failed with error %d\n", WSAGetLastError());
+        }
+        return 0;
+    }
+
+    remote_ip = cli_addr.sin_addr.s_addr;
+    remote_port = ntohs(cli_addr.sin_port);
+    return iResult;
+}
+
+int udp_send(uint32_t ip, uint16_t port, const char *buffer, int buffer_size) {
+    if (udp_socket == INVALID_SOCKET) return 0;
+
+    sockaddr_in dest_addr;
+    ZeroMemory(&dest_addr, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_addr.s_addr = ip;
+    dest_addr.sin_port = htons(port);
+    int iResult = ::sendto(udp_socket, buffer, buffer_size, 0, (sockaddr *)&dest_addr, sizeof(dest_addr));
+    if (iResult == SOCKET_ERROR) {
+        DebugTraceF("EHTERNET: UDP sendto failed with error %d\n", WSAGetLastError());
+        return 0;
+    }
+
+    return iResult;
+}
+
 }
 }
 } // namespace eez::psu::ethernet_platform
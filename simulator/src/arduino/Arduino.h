@@ -79,6 +79,12 @@ private:
     } _address;
 
 public:
+    IPAddress() { _address.dword = 0; }
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        _address.bytes[0] = a; _address.bytes[1] = b; _address.bytes[2] = c; _address.bytes[3] = d;
+    }
+    IPAddress(uint32_t address) { _address.dword = address; }
+
     operator uint32_t() const { return _address.dword; };
 };
 
@@ -42,11 +42,15 @@ namespace arduino {
 class SPISettings {
 public:
     SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode);
+
+    uint32_t clock;
 };
 
 /// Bare minimum implementation of the Arduino SPI object
 class SimulatorSPI {
 public:
+    SimulatorSPI();
+
     void begin();
 
     void usingInterrupt(uint8_t interruptNumber);
@@ -58,6 +62,10 @@ public:
 	void setBitOrder(int _order);
 	void setDataMode(uint8_t _mode);
 	void setClockDivider(uint8_t _div);
+
+private:
+    /// SPI clock frequency in Hz
+    uint32_t clock;
 };
 
 extern SimulatorSPI SPI;
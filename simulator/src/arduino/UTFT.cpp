@@ -30,6 +30,8 @@ UTFT::UTFT(byte , int , int , int , int , int) {
     disp_x_size = 239;
     disp_y_size = 319;
     buffer = new word[getDisplayXSize() * getDisplayYSize()];
+    numPixelWrites = 0;
+    numAddressWrites = 0;
 }
 
 UTFT::~UTFT() {
@@ -85,6 +87,8 @@ void UTFT::setBrightness(byte br) {
 }
 
 void UTFT::setPixel(word color) {
+    ++numPixelWrites;
+
     if (orient == PORTRAIT) {
         if (x >= 0 && x < getDisplayXSize() && y >= 0 && y < getDisplayYSize()) {
             *(buffer + y * getDisplayXSize() + x) = color;
@@ -107,6 +111,8 @@ void UTFT::setPixel(word color) {
 }
 
 void UTFT::setXY(word x1_, word y1_, word x2_, word y2_) {
+    ++numAddressWrites;
+
     x1 = x1_;
     y1 = y1_;
     x2 = x2_;
@@ -131,6 +137,9 @@ void UTFT::clrXY() {
 }
 
 void UTFT::clrScr() {
+    ++numAddressWrites;
+    numPixelWrites += getDisplayXSize() * getDisplayYSize();
+
     word *p = buffer;
     word *end = buffer + getDisplayXSize() * getDisplayYSize();
     while (p < end) {
@@ -94,6 +94,10 @@ public:
     word    x, y, x1, y1, x2, y2;
     word    *buffer;
 
+    // bus traffic counters, used by the front panel frame statistics
+    uint32_t numPixelWrites;
+    uint32_t numAddressWrites;
+
     void setPixel(word color);
     void setXY(word x1_, word y1_, word x2_, word y2_);
     void clrXY();
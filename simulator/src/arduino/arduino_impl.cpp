@@ -19,6 +19,7 @@
 #include "psu.h"
 #include "arduino_internal.h"
 #include "chips.h"
+#include "scpi_trace.h"
 #include "temp_sensor.h"
 #include "front_panel/control.h"
 
@@ -84,6 +85,9 @@ void SimulatorSerial::begin(unsigned long baud) {
 }
 
 int SimulatorSerial::write(const char *buffer, int size) {
+    if (!eez::psu::simulator::scpi_trace::onOutput(eez::psu::simulator::scpi_trace::SOURCE_SERIAL, buffer, size)) {
+        return size;
+    }
     return fwrite(buffer, 1, size, stdout);
 }
 
@@ -92,19 +96,24 @@ int SimulatorSerial::print(const char *data) {
 }
 
 int SimulatorSerial::println(int value) {
-    return printf("%d\n", value);
+    char buffer[16];
+    sprintf(buffer, "%d", value);
+    return println(buffer);
 }
 
 int SimulatorSerial::println(const char *data) {
-    return printf("%s\n", data);
+    // everything goes through write so it can be captured by the SCPI trace
+    return print(data) + write("\n", 1);
 }
 
 int SimulatorSerial::println(IPAddress ipAddress) {
-    return printf("%d.%d.%d.%d\n",
+    char buffer[16];
+    sprintf(buffer, "%d.%d.%d.%d",
         ipAddress._address.bytes[0],
         ipAddress._address.bytes[1],
         ipAddress._address.bytes[2],
         ipAddress._address.bytes[3]);
+    return println(buffer);
 }
 
 int SimulatorSerial::available(void) {
@@ -118,6 +127,7 @@ int SimulatorSerial::read(void) {
 }
 
 void SimulatorSerial::put(int ch) {
+    eez::psu::simulator::scpi_trace::onInput(eez::psu::simulator::scpi_trace::SOURCE_SERIAL, (char)ch);
     input.push(ch);
 }
 
@@ -126,13 +136,23 @@ void SimulatorSerial::flush() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-SPISettings::SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
+SPISettings::SPISettings(uint32_t clock_, uint8_t bitOrder, uint8_t dataMode)
+    : clock(clock_)
+{
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 SimulatorSPI SPI;
 
+/// Arduino Due master clock, used when a raw divider is given to the setClockDivider
+#define SPI_MASTER_CLOCK 84000000
+
+SimulatorSPI::SimulatorSPI()
+    : clock(4000000)
+{
+}
+
 void SimulatorSPI::begin() {
 }
 
@@ -140,10 +160,11 @@ void SimulatorSPI::usingInterrupt(uint8_t interruptNumber) {
 }
 
 void SimulatorSPI::beginTransaction(SPISettings settings) {
+    clock = settings.clock;
 }
 
 uint8_t SimulatorSPI::transfer(uint8_t data) {
-    return chips::transfer(data);
+    return chips::transfer(data, clock);
 }
 
 void SimulatorSPI::endTransaction(void) {
@@ -159,6 +180,18 @@ void SimulatorSPI::setDataMode(uint8_t _mode) {
 }
 
 void SimulatorSPI::setClockDivider(uint8_t _div) {
+    // SPI_CLOCK_DIVx codes are relative to the 16 MHz AVR clock,
+    // anything else is a raw Arduino Due divider
+    switch (_div) {
+    case SPI_CLOCK_DIV2: clock = 8000000; break;
+    case SPI_CLOCK_DIV4: clock = 4000000; break;
+    case SPI_CLOCK_DIV8: clock = 2000000; break;
+    case SPI_CLOCK_DIV16: clock = 1000000; break;
+    case SPI_CLOCK_DIV32: clock = 500000; break;
+    case SPI_CLOCK_DIV64: clock = 250000; break;
+    case SPI_CLOCK_DIV128: clock = 125000; break;
+    default: clock = SPI_MASTER_CLOCK / _div; break;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -178,13 +211,23 @@ void tone(uint8_t _pin, unsigned int frequency, unsigned long duration) {
 #include <time.h>
 #endif
 
+/// Time spent on the simulated SPI bus transfers in microseconds.
+/// It is added to the host clock, so firmware sees the cost of SPI traffic.
+static uint64_t getSpiBusTime() {
+#if SIM_SPI_TIMING
+    return chips::getBusTime() / 1000;
+#else
+    return 0;
+#endif
+}
+
 uint32_t millis() {
 #ifdef _WIN32
-    return GetTickCount();
+    return GetTickCount() + (uint32_t)(getSpiBusTime() / 1000);
 #else
     timeval tv;
     gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
+    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec + getSpiBusTime();
     return (uint32_t)(micros / 1000);
 #endif
 }
@@ -205,7 +248,7 @@ uint32_t micros() {
         unsigned __int64 time;
         QueryPerformanceCounter((LARGE_INTEGER *)&time);
 
-        unsigned __int64 diff = (time - startTime) * 1000000L / frequency;
+        unsigned __int64 diff = (time - startTime) * 1000000L / frequency + getSpiBusTime();
 
         return (uint32_t)(diff % 4294967296);
     }
@@ -213,7 +256,7 @@ uint32_t micros() {
 #else
     timeval tv;
     gettimeofday(&tv, NULL);
-    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec;
+    uint64_t micros = tv.tv_sec*(uint64_t)1000000 + tv.tv_usec + getSpiBusTime();
     return (uint32_t)(micros % 4294967296);
 #endif
 }
@@ -20,6 +20,18 @@
 #include "chips.h"
 #include "arduino_internal.h"
 
+#ifdef _WIN32
+#undef INPUT
+#undef OUTPUT
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace eez {
 namespace psu {
 namespace simulator {
@@ -52,10 +64,41 @@ DigitalAnalogConverterChip dac_chip1(adc_chip1);
 // Instance of DAC chip for the CH2 (selected with DAC2_SELECT LOW)
 DigitalAnalogConverterChip dac_chip2(adc_chip2);
 
+static struct {
+    Chip *chip;
+    const char *name;
+} g_chips[] = {
+    { &eeprom_chip, "EEPROM" },
+    { &rtc_chip, "RTC" },
+    { &bp_chip, "BP" },
+    { &ioexp_chip1, "IOEXP1" },
+    { &ioexp_chip2, "IOEXP2" },
+    { &adc_chip1, "ADC1" },
+    { &adc_chip2, "ADC2" },
+    { &dac_chip1, "DAC1" },
+    { &dac_chip2, "DAC2" }
+};
+
+static uint64_t g_busTime;
+static bool g_spiStatisticsStarted;
+static uint32_t g_spiStatisticsStartTime;
+
 /// Currently selected chip on SPI bus
 Chip *selected_chip = 0;
 
+static void select_pin(int pin, int state);
+
 void select(int pin, int state) {
+    Chip *previously_selected_chip = selected_chip;
+
+    select_pin(pin, state);
+
+    if (selected_chip && selected_chip != previously_selected_chip) {
+        ++selected_chip->spiStatistics.transactions;
+    }
+}
+
+static void select_pin(int pin, int state) {
     if (pin == EEPROM_SELECT) {
         if (!state) {
             selected_chip = &eeprom_chip;
@@ -63,6 +106,7 @@ void select(int pin, int state) {
         }
         else {
             if (selected_chip == &eeprom_chip) {
+                eeprom_chip.deselect();
                 selected_chip = 0;
             }
         }
@@ -157,8 +201,22 @@ void select(int pin, int state) {
     }
 }
 
-uint8_t transfer(uint8_t data) {
-    return selected_chip ? selected_chip->transfer(data) : 0;
+uint8_t transfer(uint8_t data, uint32_t clock) {
+    if (!g_spiStatisticsStarted) {
+        resetSpiStatistics();
+    }
+
+    uint32_t byteTime = (uint32_t)(8 * 1000000000ULL / clock);
+    g_busTime += byteTime;
+
+    if (!selected_chip) {
+        return 0;
+    }
+
+    ++selected_chip->spiStatistics.bytes;
+    selected_chip->spiStatistics.busTime += byteTime;
+
+    return selected_chip->transfer(data);
 }
 
 void tick() {
@@ -166,26 +224,143 @@ void tick() {
     adc_chip2.tick();
 }
 
+uint64_t getBusTime() {
+    return g_busTime;
+}
+
+int getNumChips() {
+    return sizeof(g_chips) / sizeof(g_chips[0]);
+}
+
+const char *getChipName(int index) {
+    return g_chips[index].name;
+}
+
+const SpiStatistics &getSpiStatistics(int index) {
+    return g_chips[index].chip->spiStatistics;
+}
+
+uint64_t getSpiStatisticsPeriod() {
+    // micros() wraps around after ~71 minutes
+    return (uint32_t)(micros() - g_spiStatisticsStartTime) * 1000ULL;
+}
+
+void resetSpiStatistics() {
+    for (int i = 0; i < getNumChips(); ++i) {
+        g_chips[i].chip->spiStatistics.transactions = 0;
+        g_chips[i].chip->spiStatistics.bytes = 0;
+        g_chips[i].chip->spiStatistics.busTime = 0;
+    }
+    g_spiStatisticsStarted = true;
+    g_spiStatisticsStartTime = micros();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Chip::Chip() {
+    spiStatistics.transactions = 0;
+    spiStatistics.bytes = 0;
+    spiStatistics.busTime = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 EepromChip::EepromChip()
-    : state(IDLE)
+    : memory(0)
+    , snapshot(0)
+    , state(IDLE)
+    , write_cycle_pending(false)
 {
+    // EEPROM.state file is extended to the full EEPROM size and mapped into memory,
+    // so reads and writes are plain memory accesses
     char *file_path = getConfFilePath("EEPROM.state");
-    fp = fopen(file_path, "r+b");
-    if (fp == NULL) {
-        fp = fopen(file_path, "w+b");
+#ifdef _WIN32
+    file_handle = CreateFileA(file_path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    mapping_handle = NULL;
+    if (file_handle != INVALID_HANDLE_VALUE) {
+        mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READWRITE, 0, SIM_EEPROM_SIZE, NULL);
+        if (mapping_handle != NULL) {
+            memory = (uint8_t *)MapViewOfFile(mapping_handle, FILE_MAP_ALL_ACCESS, 0, 0, SIM_EEPROM_SIZE);
+        }
+    }
+#else
+    fd = open(file_path, O_RDWR | O_CREAT, 0644);
+    if (fd != -1) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && (st.st_size >= SIM_EEPROM_SIZE || ftruncate(fd, SIM_EEPROM_SIZE) == 0)) {
+            void *p = mmap(0, SIM_EEPROM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) {
+                memory = (uint8_t *)p;
+            }
+        }
     }
+#endif
 }
 
 EepromChip::~EepromChip() {
-    if (fp != NULL) fclose(fp);
+#ifdef _WIN32
+    if (memory) {
+        FlushViewOfFile(memory, 0);
+        UnmapViewOfFile(memory);
+    }
+    if (mapping_handle != NULL) CloseHandle(mapping_handle);
+    if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+#else
+    if (memory) {
+        msync(memory, SIM_EEPROM_SIZE, MS_SYNC);
+        munmap(memory, SIM_EEPROM_SIZE);
+    }
+    if (fd != -1) close(fd);
+#endif
+    delete [] snapshot;
 }
 
 void EepromChip::select() {
     state = IDLE;
 }
 
+void EepromChip::deselect() {
+#if SIM_SPI_TIMING
+    // internal write cycle starts when chip is deselected after the data is sent
+    if (state == WRITE) {
+        write_cycle_pending = true;
+        write_cycle_start = micros();
+    }
+#endif
+
+    if (state == WRITE) {
+        flush();
+    }
+}
+
+void EepromChip::saveSnapshot() {
+    if (!snapshot) {
+        snapshot = new uint8_t[SIM_EEPROM_SIZE];
+    }
+
+    if (memory) {
+        memcpy(snapshot, memory, SIM_EEPROM_SIZE);
+    } else {
+        memset(snapshot, 0, SIM_EEPROM_SIZE);
+    }
+}
+
+bool EepromChip::restoreSnapshot() {
+    if (!snapshot) {
+        return false;
+    }
+
+    if (memory) {
+        memcpy(memory, snapshot, SIM_EEPROM_SIZE);
+        flush();
+    }
+
+    write_cycle_pending = false;
+    state = IDLE;
+
+    return true;
+}
+
 uint8_t EepromChip::transfer(uint8_t data) {
     uint8_t result = 0;
 
@@ -227,24 +402,37 @@ uint8_t EepromChip::transfer(uint8_t data) {
         if (++address_index == 64) address_index = 0;
     }
     else if (state == RDSR) {
+        if (write_cycle_pending) {
+            if (micros() - write_cycle_start < SIM_EEPROM_WRITE_CYCLE_TIME) {
+                result = 1 << 0; // WIP
+            } else {
+                write_cycle_pending = false;
+            }
+        }
     }
 
     return result;
 }
 
 uint8_t EepromChip::read_byte() {
-    if (fp == NULL) return 0;
-    fseek(fp, address + address_index, SEEK_SET);
-    uint8_t data = 0;
-    fread(&data, 1, 1, fp);
-    return data;
+    if (!memory) return 0;
+    return memory[(address + address_index) % SIM_EEPROM_SIZE];
 }
 
 void EepromChip::write_byte(uint8_t data) {
-    if (fp == NULL) return;
-    fseek(fp, address + address_index, SEEK_SET);
-    fwrite(&data, 1, 1, fp);
-    fflush(fp);
+    if (!memory) return;
+    memory[(address + address_index) % SIM_EEPROM_SIZE] = data;
+}
+
+void EepromChip::flush() {
+    if (!memory) return;
+    // schedule write back to the EEPROM.state file,
+    // mapping is shared so the content is already visible to other processes
+#ifdef _WIN32
+    FlushViewOfFile(memory, 0);
+#else
+    msync(memory, SIM_EEPROM_SIZE, MS_ASYNC);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -590,6 +778,7 @@ AnalogDigitalConverterChip::AnalogDigitalConverterChip(IOExpanderChip &ioexp_chi
     , state(IDLE)
     , tick_counter(0)
     , start(false)
+    , data(0)
 {
 }
 
@@ -619,6 +808,7 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
         }
         else if (data == AnalogDigitalConverter::ADC_START) {
             start = true;
+            start_time = micros();
             tick();
         }
     }
@@ -633,11 +823,15 @@ uint8_t AnalogDigitalConverterChip::transfer(uint8_t data) {
         state = IDLE;
     }
     else if (state == RDATA_MSB) {
-        result = getValue() >> 8;
+        // until the conversion is finished the previous result is returned
+        if (start && micros() - start_time >= getConversionTime()) {
+            endConversion();
+        }
+        result = this->data >> 8;
         state = RDATA_LSB;
     }
     else if (state == RDATA_LSB) {
-        result = getValue() & 0xFF;
+        result = this->data & 0xFF;
     }
 
     return result;
@@ -647,11 +841,8 @@ void AnalogDigitalConverterChip::tick() {
     if (tick_counter < 4) {
         ++tick_counter;
 
-        if (start) {
-            start = false;
-
-            //static const int CODE_TO_SPS [] = { 20, 45, 90, 175, 330, 600, 1000 };
-            //psu::delayMicroseconds(1000000 / CODE_TO_SPS[ADC_SPS]);
+        if (start && micros() - start_time >= getConversionTime()) {
+            endConversion();
 
             InterruptCallback callback = interrupt_callbacks[convend_pin];
             if (callback) {
@@ -663,6 +854,25 @@ void AnalogDigitalConverterChip::tick() {
     }
 }
 
+uint32_t AnalogDigitalConverterChip::getConversionTime() {
+#if SIM_SPI_TIMING
+    static const uint32_t CODE_TO_SPS[] = { 20, 45, 90, 175, 330, 600, 1000, 1000 };
+    // data rate is in bits 7:5 of the register 1, turbo mode (bits 4:3 == 10) doubles it
+    uint32_t sps = CODE_TO_SPS[register_values[1] >> 5];
+    if (((register_values[1] >> 3) & 3) == 2) {
+        sps *= 2;
+    }
+    return 1000000 / sps;
+#else
+    return 0;
+#endif
+}
+
+void AnalogDigitalConverterChip::endConversion() {
+    start = false;
+    data = getValue();
+}
+
 uint16_t AnalogDigitalConverterChip::getValue() {
     updateValues();
 
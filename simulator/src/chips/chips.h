@@ -42,20 +42,44 @@ namespace chips {
 void select(int pin, int state);
 
 /// Transfers data to currently selected chip.
-/// \param pin Pin number
-uint8_t transfer(uint8_t data);
+/// \param data Byte to send
+/// \param clock SPI clock frequency in Hz, used to account the bus time
+uint8_t transfer(uint8_t data, uint32_t clock);
 
 /// This should be called periodically by the simulator main loop.
 /// For the case if some of the chips need to do something in the background.
 void tick();
 
+/// Total time spent on SPI bus transfers in nanoseconds. Simulator clock
+/// is advanced by this amount, so firmware sees the cost of the SPI traffic.
+uint64_t getBusTime();
+
+/// SPI bus usage of the single chip.
+struct SpiStatistics {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint64_t busTime; // in nanoseconds
+};
+
+int getNumChips();
+const char *getChipName(int index);
+const SpiStatistics &getSpiStatistics(int index);
+/// Time in nanoseconds since the SPI statistics were collected from.
+uint64_t getSpiStatisticsPeriod();
+void resetSpiStatistics();
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Abstract base class for all the chips.
 class Chip {
 public:
+    Chip();
+
     virtual void select() = 0;
+    virtual void deselect() {}
     virtual uint8_t transfer(uint8_t data) = 0;
+
+    SpiStatistics spiStatistics;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,17 +102,36 @@ public:
     ~EepromChip();
 
     void select();
+    void deselect();
     uint8_t transfer(uint8_t data);
 
+    /// Keeps a copy of the current EEPROM content in memory.
+    void saveSnapshot();
+    /// Replaces EEPROM content with the copy taken by saveSnapshot.
+    /// \returns false if there is no snapshot
+    bool restoreSnapshot();
+
 private:
-    FILE *fp;
+    /// EEPROM.state file mapped into memory, 0 if mapping failed
+    uint8_t *memory;
+#ifdef _WIN32
+    void *file_handle;
+    void *mapping_handle;
+#else
+    int fd;
+#endif
+    uint8_t *snapshot;
 
     State state;
     uint16_t address;
     uint16_t address_index;
 
+    bool write_cycle_pending;
+    uint32_t write_cycle_start;
+
     uint8_t read_byte();
     void write_byte(uint8_t);
+    void flush();
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -258,7 +301,11 @@ private:
     uint16_t i_set;
     int tick_counter;
     bool start;
+    uint32_t start_time;
+    uint16_t data;
 
+    uint32_t getConversionTime();
+    void endConversion();
     uint16_t getValue();
     void setDacValue(uint8_t data_buffer, uint16_t value);
     void updateValues();
@@ -289,6 +336,7 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+extern EepromChip eeprom_chip;
 extern BPChip bp_chip;
 
 ////////////////////////////////////////////////////////////////////////////////
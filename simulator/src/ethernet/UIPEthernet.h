@@ -18,6 +18,10 @@
 
 #pragma once
 
+#define DHCP_ASYNC_PENDING 0
+#define DHCP_ASYNC_LEASED 1
+#define DHCP_ASYNC_FAILED 2
+
 namespace eez {
 namespace psu {
 namespace simulator {
@@ -34,10 +38,17 @@ class SimulatorEthernet {
 public:
     bool begin(uint8_t *mac);
 
+    /// Starts simulated DHCP, it finishes after the same 1 second begin takes.
+    int beginAsync(uint8_t *mac);
+    int pollAsync();
+
     IPAddress localIP();
     IPAddress subnetMask();
     IPAddress gatewayIP();
     IPAddress dnsServerIP();
+
+private:
+    uint32_t beginAsyncTime;
 };
 
 extern SimulatorEthernet Ethernet;
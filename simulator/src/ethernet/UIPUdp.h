@@ -0,0 +1,64 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace arduino {
+
+/// Bare minimum implementation of the Arduino EthernetUDP class
+class EthernetUDP {
+public:
+    EthernetUDP();
+
+    uint8_t begin(uint16_t port);
+
+    int parsePacket();
+    int read(uint8_t *buffer, size_t len);
+    IPAddress remoteIP() { return remote_ip; }
+    uint16_t remotePort() { return remote_port; }
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    size_t write(const uint8_t *buffer, size_t size);
+    int endPacket();
+
+private:
+    static const size_t BUFFER_SIZE = 512;
+
+    bool bind_result;
+
+    uint8_t rx_buffer[BUFFER_SIZE];
+    int rx_size;
+    int rx_position;
+    IPAddress remote_ip;
+    uint16_t remote_port;
+
+    uint8_t tx_buffer[BUFFER_SIZE];
+    size_t tx_size;
+    IPAddress tx_ip;
+    uint16_t tx_port;
+};
+
+}
+}
+}
+} // namespace eez::psu::simulator::arduino;
+
+using namespace eez::psu::simulator::arduino;
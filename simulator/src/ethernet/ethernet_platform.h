@@ -33,6 +33,10 @@ int write(const char *buffer, int buffer_size);
 
 void stop();
 
+bool udp_bind(int port);
+int udp_recv(char *buffer, int buffer_size, uint32_t &remote_ip, uint16_t &remote_port);
+int udp_send(uint32_t ip, uint16_t port, const char *buffer, int buffer_size);
+
 }
 }
 } // namespace eez::psu::ethernet_platform
@@ -20,7 +20,9 @@
 #include "UIPEthernet.h"
 #include "UIPServer.h"
 #include "UIPClient.h"
+#include "UIPUdp.h"
 #include "ethernet_platform.h"
+#include "scpi_trace.h"
 
 namespace eez {
 namespace psu {
@@ -41,6 +43,15 @@ bool SimulatorEthernet::begin(uint8_t *mac) {
     return true;
 }
 
+int SimulatorEthernet::beginAsync(uint8_t *mac) {
+    beginAsyncTime = millis();
+    return 1;
+}
+
+int SimulatorEthernet::pollAsync() {
+    return millis() - beginAsyncTime >= 1000 ? DHCP_ASYNC_LEASED : DHCP_ASYNC_PENDING;
+}
+
 IPAddress SimulatorEthernet::localIP() {
     return IPAddress();
 }
@@ -92,10 +103,17 @@ size_t EthernetClient::available() {
 }
 
 size_t EthernetClient::read(uint8_t* buffer, size_t buffer_size) {
-    return ethernet_platform::read((char *)buffer, (int)buffer_size);
+    int size = ethernet_platform::read((char *)buffer, (int)buffer_size);
+    for (int i = 0; i < size; ++i) {
+        eez::psu::simulator::scpi_trace::onInput(eez::psu::simulator::scpi_trace::SOURCE_ETHERNET, (char)buffer[i]);
+    }
+    return size;
 }
 
 size_t EthernetClient::write(const char *buffer, size_t buffer_size) {
+    if (!eez::psu::simulator::scpi_trace::onOutput(eez::psu::simulator::scpi_trace::SOURCE_ETHERNET, buffer, (int)buffer_size)) {
+        return buffer_size;
+    }
     return ethernet_platform::write(buffer, (int)buffer_size);
 }
 
@@ -106,6 +124,65 @@ void EthernetClient::stop() {
     ethernet_platform::stop();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+EthernetUDP::EthernetUDP() : bind_result(false), rx_size(0), rx_position(0), remote_port(0), tx_size(0), tx_port(0) {
+}
+
+uint8_t EthernetUDP::begin(uint16_t port) {
+    bind_result = ethernet_platform::udp_bind(port);
+    return bind_result ? 1 : 0;
+}
+
+int EthernetUDP::parsePacket() {
+    rx_size = 0;
+    rx_position = 0;
+
+    if (!bind_result) return 0;
+
+    uint32_t ip;
+    uint16_t port;
+    int size = ethernet_platform::udp_recv((char *)rx_buffer, BUFFER_SIZE, ip, port);
+    if (size > 0) {
+        rx_size = size;
+        remote_ip = IPAddress(ip);
+        remote_port = port;
+    }
+
+    return rx_size;
+}
+
+int EthernetUDP::read(uint8_t *buffer, size_t len) {
+    int n = rx_size - rx_position;
+    if (n > (int)len) {
+        n = (int)len;
+    }
+    memcpy(buffer, rx_buffer + rx_position, n);
+    rx_position += n;
+    return n;
+}
+
+int EthernetUDP::beginPacket(IPAddress ip, uint16_t port) {
+    tx_size = 0;
+    tx_ip = ip;
+    tx_port = port;
+    return bind_result ? 1 : 0;
+}
+
+size_t EthernetUDP::write(const uint8_t *buffer, size_t size) {
+    if (size > BUFFER_SIZE - tx_size) {
+        size = BUFFER_SIZE - tx_size;
+    }
+    memcpy(tx_buffer + tx_size, buffer, size);
+    tx_size += size;
+    return size;
+}
+
+int EthernetUDP::endPacket() {
+    if (!bind_result) return 0;
+    return ethernet_platform::udp_send(tx_ip, tx_port, (const char *)tx_buffer, (int)tx_size) == (int)tx_size ? 1 : 0;
+}
+
 }
 }
 }
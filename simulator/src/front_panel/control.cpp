@@ -55,12 +55,14 @@ static eez_dll_lib_t g_lib = 0;
 static create_window_ptr_t g_create_window_ptr = 0;
 static get_desktop_resolution_ptr_t g_get_desktop_resolution_ptr = 0;
 static Window* g_window;
+static bool g_headless;
 static Data g_data;
 
 static beep_ptr_t g_beep_ptr = 0;
 
 void load_lib() {
-    if (!g_lib_loaded) {
+    // no window and no sound in headless mode
+    if (!g_lib_loaded && !g_headless) {
         g_lib = eez_dll_load(LIB_FILE_PATH);
         if (g_lib) {
             g_create_window_ptr = (create_window_ptr_t)eez_dll_get_proc_address(g_lib, "eez_imgui_create_window");
@@ -80,11 +82,11 @@ void load_lib() {
 #if OPTION_DISPLAY
 
 bool isOpened() {
-    return g_window ? true : false;
+    return g_window || g_headless ? true : false;
 }
 
 bool open() {
-    if (g_window) {
+    if (g_window || g_headless) {
         return true;
     }
 
@@ -107,6 +109,15 @@ bool open() {
     return g_window != 0;
 }
 
+bool openHeadless() {
+    g_headless = true;
+    return true;
+}
+
+bool isHeadless() {
+    return g_headless;
+}
+
 void close() {
     if (g_window) {
         delete g_window;
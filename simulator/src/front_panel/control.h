@@ -27,6 +27,11 @@ namespace front_panel {
 bool isOpened();
 bool open();
 void close();
+
+/// Open the front panel without a window, GUI is then rendered only into
+/// the in-memory framebuffer and driven by the scripted touch/encoder events.
+bool openHeadless();
+bool isHeadless();
 void tick();
 
 void beep(double freq, int duration);
@@ -0,0 +1,130 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+
+#if OPTION_DISPLAY
+
+#include "front_panel/headless.h"
+#include "lcd.h"
+#include "touch.h"
+#if OPTION_ENCODER
+#include "encoder.h"
+#endif
+
+#include <map>
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace front_panel {
+
+static std::map<int, PageFrameStatistics> g_frameStatistics;
+
+static uint32_t g_frameStartTime;
+static uint32_t g_frameStartPixelWrites;
+static uint32_t g_frameStartAddressWrites;
+
+void beginFrame() {
+    g_frameStartTime = micros();
+    g_frameStartPixelWrites = gui::lcd::lcd.numPixelWrites;
+    g_frameStartAddressWrites = gui::lcd::lcd.numAddressWrites;
+}
+
+void endFrame(int pageId) {
+    uint32_t renderTime = micros() - g_frameStartTime;
+
+    PageFrameStatistics &stats = g_frameStatistics[pageId];
+    stats.pageId = pageId;
+
+    ++stats.frames;
+
+    uint32_t pixelWrites = gui::lcd::lcd.numPixelWrites - g_frameStartPixelWrites;
+    if (pixelWrites > 0) {
+        ++stats.dirtyFrames;
+        stats.pixelWrites += pixelWrites;
+        stats.addressWrites += gui::lcd::lcd.numAddressWrites - g_frameStartAddressWrites;
+        stats.renderTimeTotal += renderTime;
+        if (renderTime > stats.renderTimeMax) {
+            stats.renderTimeMax = renderTime;
+        }
+    }
+}
+
+void resetFrameStatistics() {
+    g_frameStatistics.clear();
+}
+
+int getFrameStatistics(PageFrameStatistics *stats, int max) {
+    int n = 0;
+    for (std::map<int, PageFrameStatistics>::iterator it = g_frameStatistics.begin(); it != g_frameStatistics.end(); ++it, ++n) {
+        if (n < max) {
+            stats[n] = it->second;
+        }
+    }
+    return n;
+}
+
+bool saveScreenshot(const char *file_path) {
+    FILE *fp = fopen(file_path, "wb");
+    if (!fp) {
+        return false;
+    }
+
+    int w = gui::lcd::lcd.getDisplayXSize();
+    int h = gui::lcd::lcd.getDisplayYSize();
+
+    fprintf(fp, "P6\n%d %d\n255\n", w, h);
+
+    word *src = gui::lcd::lcd.buffer;
+    for (int i = 0; i < w * h; ++i) {
+        word color = *src++; // rrrrrggggggbbbbb
+
+        uint8_t r = (color >> 11) & 0x1F;
+        uint8_t g = (color >> 5) & 0x3F;
+        uint8_t b = color & 0x1F;
+
+        uint8_t rgb[3] = {
+            (uint8_t)((r << 3) | (r >> 2)),
+            (uint8_t)((g << 2) | (g >> 4)),
+            (uint8_t)((b << 3) | (b >> 2))
+        };
+        fwrite(rgb, 1, 3, fp);
+    }
+
+    bool result = ferror(fp) == 0;
+    fclose(fp);
+    return result;
+}
+
+void touch(bool isPressed, int x, int y) {
+    gui::touch::touch_write(isPressed, x, y);
+}
+
+void encoder(int counter, bool clicked) {
+#if OPTION_ENCODER
+    psu::encoder::write(counter, clicked);
+#endif
+}
+
+}
+}
+}
+} // namespace eez::psu::simulator::front_panel
+
+#endif
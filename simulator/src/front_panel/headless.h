@@ -0,0 +1,62 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace front_panel {
+
+/// Rendering cost of the GUI page, collected per frame drawn by the firmware.
+struct PageFrameStatistics {
+    int pageId;
+    /// Number of the frames drawn while page was active
+    uint32_t frames;
+    /// Number of the frames in which at least one pixel was written
+    uint32_t dirtyFrames;
+    /// Number of the pixels written to the display
+    uint32_t pixelWrites;
+    /// Number of the address window changes
+    uint32_t addressWrites;
+    /// Total and max. time spent in drawing the dirty frames in microseconds
+    uint32_t renderTimeTotal;
+    uint32_t renderTimeMax;
+};
+
+/// Called by the GUI before it starts drawing the frame.
+void beginFrame();
+/// Called by the GUI after the frame is drawn.
+void endFrame(int pageId);
+
+void resetFrameStatistics();
+/// \returns number of the pages with collected statistics,
+/// at most max entries are copied into stats.
+int getFrameStatistics(PageFrameStatistics *stats, int max);
+
+/// Save the display framebuffer as a binary PPM image.
+bool saveScreenshot(const char *file_path);
+
+/// Scripted interaction, i.e. when there is no front panel window.
+void touch(bool isPressed, int x, int y);
+void encoder(int counter, bool clicked);
+
+}
+}
+}
+} // namespace eez::psu::simulator::front_panel
@@ -18,18 +18,56 @@
 
 #include "psu.h"
 #include "main_loop.h"
+#include "scpi_trace.h"
 #if OPTION_DISPLAY
 #include "front_panel/control.h"
 #endif
 
 using namespace eez::psu;
 
-int main() {
+/// Command line options:
+///   --record <file>        record SCPI session to the trace file
+///   --replay <file>        replay trace file as fast as possible and exit
+///   --replay-timed <file>  replay trace file preserving recorded pauses and exit
+///   --headless             render GUI only into the in-memory framebuffer
+int main(int argc, char **argv) {
+    const char *recordFilePath = 0;
+    const char *replayFilePath = 0;
+    bool replayTimed = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+#if OPTION_DISPLAY
+            simulator::front_panel::openHeadless();
+#endif
+        } else if (i + 1 == argc) {
+            break;
+        } else if (strcmp(argv[i], "--record") == 0) {
+            recordFilePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            replayFilePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay-timed") == 0) {
+            replayFilePath = argv[++i];
+            replayTimed = true;
+        }
+    }
+
     simulator::init();
     boot();
-    main_loop();
+
+    int result = 0;
+    if (replayFilePath) {
+        result = simulator::scpi_trace::replay(replayFilePath, replayTimed) == 0 ? 0 : 1;
+    } else {
+        if (recordFilePath && !simulator::scpi_trace::startRecording(recordFilePath)) {
+            printf("Can't create SCPI trace file \"%s\"\n", recordFilePath);
+        }
+        main_loop();
+        simulator::scpi_trace::stopRecording();
+    }
+
 #if OPTION_DISPLAY
     simulator::front_panel::close();
 #endif
-    return 0;
+    return result;
 }
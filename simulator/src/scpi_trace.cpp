@@ -0,0 +1,280 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "psu.h"
+#include "serial_psu.h"
+#include "scpi_trace.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+namespace eez {
+namespace psu {
+namespace simulator {
+namespace scpi_trace {
+
+struct Line {
+    bool input;
+    uint32_t time;
+    std::string text;
+};
+
+static FILE *g_recordFile;
+static uint32_t g_recordStartTime;
+static std::string g_inputLine[2];
+static std::string g_outputLine[2];
+
+static bool g_replaying;
+static std::string g_replayOutputLine;
+static std::vector<std::string> g_replayOutput;
+
+/// Debug traces are asynchronous and depend on the timing, they are kept
+/// in the recording but not compared.
+static bool isDebugTrace(const std::string &text) {
+    return text.compare(0, 7, "**TRACE") == 0;
+}
+
+static char getSourceChar(Source source) {
+    return source == SOURCE_SERIAL ? 'S' : 'E';
+}
+
+static void recordLine(char direction, Source source, std::string &line) {
+    if (!line.empty() && line[line.size() - 1] == '\r') {
+        line.resize(line.size() - 1);
+    }
+    fprintf(g_recordFile, "%c %c %u %s\n", direction, getSourceChar(source), (unsigned)(micros() - g_recordStartTime), line.c_str());
+    fflush(g_recordFile);
+    line.clear();
+}
+
+bool startRecording(const char *file_path) {
+    stopRecording();
+
+    g_recordFile = fopen(file_path, "w");
+    if (!g_recordFile) {
+        return false;
+    }
+
+    g_recordStartTime = micros();
+    return true;
+}
+
+void stopRecording() {
+    if (g_recordFile) {
+        fclose(g_recordFile);
+        g_recordFile = 0;
+    }
+}
+
+void onInput(Source source, char ch) {
+    if (!g_recordFile) {
+        return;
+    }
+
+    if (ch == '\n') {
+        recordLine('>', source, g_inputLine[source]);
+    } else {
+        g_inputLine[source] += ch;
+    }
+}
+
+bool onOutput(Source source, const char *buffer, int size) {
+    if (g_replaying) {
+        for (int i = 0; i < size; ++i) {
+            if (buffer[i] == '\n') {
+                if (!isDebugTrace(g_replayOutputLine)) {
+                    g_replayOutput.push_back(g_replayOutputLine);
+                }
+                g_replayOutputLine.clear();
+            } else if (buffer[i] != '\r') {
+                g_replayOutputLine += buffer[i];
+            }
+        }
+        return false;
+    }
+
+    if (g_recordFile) {
+        for (int i = 0; i < size; ++i) {
+            if (buffer[i] == '\n') {
+                recordLine('<', source, g_outputLine[source]);
+            } else {
+                g_outputLine[source] += buffer[i];
+            }
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool load(const char *file_path, std::vector<Line> &lines) {
+    FILE *fp = fopen(file_path, "r");
+    if (!fp) {
+        return false;
+    }
+
+    char buffer[SCPI_PARSER_INPUT_BUFFER_LENGTH + 32];
+    while (fgets(buffer, sizeof(buffer), fp)) {
+        char direction;
+        char source;
+        unsigned time;
+        int offset;
+        if (sscanf(buffer, "%c %c %u %n", &direction, &source, &time, &offset) < 3 || (direction != '>' && direction != '<')) {
+            continue;
+        }
+
+        Line line;
+        line.input = direction == '>';
+        line.time = time;
+        line.text = buffer + offset;
+        while (!line.text.empty() && (line.text[line.text.size() - 1] == '\n' || line.text[line.text.size() - 1] == '\r')) {
+            line.text.resize(line.text.size() - 1);
+        }
+        lines.push_back(line);
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/// Error messages are stamped with the time they were generated,
+/// leave the stamp out when comparing.
+static std::string normalize(const std::string &text) {
+    if (text.compare(0, 9, "**ERROR [") == 0) {
+        size_t end = text.find(']');
+        if (end != std::string::npos) {
+            return "**ERROR " + text.substr(end + 1);
+        }
+    }
+    return text;
+}
+
+static std::string getHeader(const std::string &command) {
+    std::string header = command.substr(0, command.find(' '));
+    for (size_t i = 0; i < header.size(); ++i) {
+        header[i] = toupper(header[i]);
+    }
+    return header;
+}
+
+/// Exit command would terminate the simulator before the report is printed.
+static bool isExitCommand(const std::string &header) {
+    size_t start = header[0] == ':' ? 1 : 0;
+    return header.compare(start, std::string::npos, "SIMU:EXIT") == 0 ||
+        header.compare(start, std::string::npos, "SIMULATOR:EXIT") == 0;
+}
+
+static uint32_t getPercentile(const std::vector<uint32_t> &sorted, int percentile) {
+    return sorted[(sorted.size() - 1) * percentile / 100];
+}
+
+int replay(const char *file_path, bool realTime) {
+    std::vector<Line> lines;
+    if (!load(file_path, lines)) {
+        printf("Can't open SCPI trace file \"%s\"\n", file_path);
+        return -1;
+    }
+
+    g_replaying = true;
+
+    int numCommands = 0;
+    int numMismatches = 0;
+    std::map<std::string, std::vector<uint32_t> > latencies;
+
+    uint32_t startTime = micros();
+
+    for (size_t i = 0; i < lines.size(); ) {
+        if (!lines[i].input) {
+            // response without a command, i.e. an asynchronous message
+            ++i;
+            continue;
+        }
+
+        const Line &command = lines[i++];
+        std::string header = getHeader(command.text);
+        if (isExitCommand(header)) {
+            break;
+        }
+
+        std::vector<std::string> expected;
+        for (; i < lines.size() && !lines[i].input; ++i) {
+            if (!isDebugTrace(lines[i].text)) {
+                expected.push_back(normalize(lines[i].text));
+            }
+        }
+
+        if (realTime) {
+            while ((int32_t)(micros() - startTime - command.time) < 0) {
+                tick();
+            }
+        }
+
+        g_replayOutput.clear();
+
+        uint32_t commandStartTime = micros();
+
+        scpi::input(serial::scpi_context, command.text.c_str(), command.text.size());
+        scpi::input(serial::scpi_context, '\n');
+
+        while (g_replayOutput.size() < expected.size() && micros() - commandStartTime < SIM_SCPI_TRACE_REPLAY_TIMEOUT) {
+            tick();
+        }
+
+        uint32_t latency = micros() - commandStartTime;
+
+        ++numCommands;
+        latencies[header].push_back(latency);
+
+        bool match = g_replayOutput.size() == expected.size();
+        for (size_t j = 0; match && j < expected.size(); ++j) {
+            match = normalize(g_replayOutput[j]) == expected[j];
+        }
+
+        if (!match) {
+            ++numMismatches;
+            printf("@@ %u %s\n", (unsigned)command.time, command.text.c_str());
+            for (size_t j = 0; j < expected.size(); ++j) {
+                printf("- %s\n", expected[j].c_str());
+            }
+            for (size_t j = 0; j < g_replayOutput.size(); ++j) {
+                printf("+ %s\n", normalize(g_replayOutput[j]).c_str());
+            }
+        }
+    }
+
+    g_replaying = false;
+
+    printf("%d commands replayed in %u ms, %d mismatched\n", numCommands, (unsigned)((micros() - startTime) / 1000), numMismatches);
+    printf("%-32s %6s %8s %8s %8s %8s [us]\n", "command", "count", "min", "p50", "p95", "max");
+    for (std::map<std::string, std::vector<uint32_t> >::iterator it = latencies.begin(); it != latencies.end(); ++it) {
+        std::vector<uint32_t> &sorted = it->second;
+        std::sort(sorted.begin(), sorted.end());
+        printf("%-32s %6d %8u %8u %8u %8u\n", it->first.c_str(), (int)sorted.size(),
+            (unsigned)sorted.front(), (unsigned)getPercentile(sorted, 50), (unsigned)getPercentile(sorted, 95), (unsigned)sorted.back());
+    }
+
+    return numMismatches;
+}
+
+}
+}
+}
+} // namespace eez::psu::simulator::scpi_trace
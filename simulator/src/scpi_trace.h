@@ -0,0 +1,62 @@
+/*
+ * EEZ PSU Firmware
+ * Copyright (C) 2017-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+namespace eez {
+namespace psu {
+namespace simulator {
+/// Record and replay of SCPI sessions.
+///
+/// Trace file is a plain text file with one line per inbound command or
+/// outbound response line, prefixed with direction, interface and a
+/// timestamp in microseconds since the start of the recording:
+///
+///     > S 1203456 MEAS:VOLT?
+///     < S 1203712 10.00
+namespace scpi_trace {
+
+enum Source {
+    SOURCE_SERIAL,
+    SOURCE_ETHERNET
+};
+
+/// Start capturing SCPI traffic to the file.
+bool startRecording(const char *file_path);
+void stopRecording();
+
+/// Must be called for every character received over the SCPI interface.
+void onInput(Source source, char ch);
+
+/// Must be called for every chunk of data sent back over the SCPI interface.
+/// \returns false if data should not be forwarded to the interface,
+/// i.e. while the replay is in progress.
+bool onOutput(Source source, const char *buffer, int size);
+
+/// Replay recorded trace against the firmware, diff the responses and print
+/// per command latency distribution.
+/// \param realTime If true recorded pauses between commands are preserved,
+/// otherwise commands are sent as fast as firmware is able to process them.
+/// \returns number of commands with responses different from the recorded ones
+/// or -1 if trace file could not be read.
+int replay(const char *file_path, bool realTime);
+
+}
+}
+}
+} // namespace eez::psu::simulator::scpi_trace
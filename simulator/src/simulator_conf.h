@@ -32,3 +32,23 @@
 
 #define SIM_FRONT_PANEL_LARGE_MODE_MIN_WIDTH 2560
 
+// SIMU:CRC32:BENC? block size (default and max.) and min. duration in microseconds
+#define SIM_CRC32_BENCHMARK_DEF_SIZE 1024
+#define SIM_CRC32_BENCHMARK_MAX_SIZE 65536
+#define SIM_CRC32_BENCHMARK_DURATION 200000UL
+
+// Max. number of pages reported by SIMU:GUI:STAT?
+#define SIM_GUI_STATISTICS_MAX_PAGES 64
+
+// Max. time replay waits for all the recorded responses to a command
+#define SIM_SCPI_TRACE_REPLAY_TIMEOUT 2000000UL
+
+// Account SPI bus transfer time, EEPROM write cycle and ADC conversion time
+#define SIM_SPI_TIMING 1
+
+// EEPROM internal write cycle time in microseconds (AT25256B max. is 5 ms,
+// firmware waits max. 3 ms, so typical value is used)
+#define SIM_EEPROM_WRITE_CYCLE_TIME 2000
+
+// Size of the simulated AT25256B EEPROM in bytes
+#define SIM_EEPROM_SIZE 32768
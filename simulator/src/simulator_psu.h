@@ -42,6 +42,7 @@
 #define vsnprintf_P vsnprintf
 #define strcmp_P strcmp
 #define strncmp_P strncmp
+#define strlen_P strlen
 
 extern void eez_psu_init();
 